@@ -0,0 +1,180 @@
+#include "platform.h"
+#include "atlas.h"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+/**
+ * One queued draw: a part of a texture at a position and angle.
+ */
+struct draw_quad {
+    draw_layer layer;   // Draw layer, sorted on first
+    int page;           // Atlas page, or -1 for an image outside the atlas
+    bitmap texture;     // The atlas page or the image itself
+    rectangle source;   // The part of the texture to draw
+    double x;           // Where to draw the part
+    double y;
+    double angle;       // Rotation in degrees
+};
+
+// The atlas pages
+static std::vector<bitmap> atlas_pages;
+
+// Where each packed image is
+static std::unordered_map<bitmap, atlas_region> atlas_regions;
+
+// Quads queued since the last flush; the vector keeps its memory between frames
+static std::vector<draw_quad> draw_batch;
+
+/**
+ * Pack images into atlas pages by shelf packing, tallest first.
+ *
+ * @param images The images to pack; duplicates are packed once.
+ */
+void build_atlas(const std::vector<bitmap> &images) {
+    atlas_pages.clear();
+    atlas_regions.clear();
+
+    // Drop duplicates, keeping the first of each so the layout only depends on the list
+    std::vector<bitmap> sorted;
+    for (bitmap image : images) {
+        if (std::find(sorted.begin(), sorted.end(), image) == sorted.end()) {
+            sorted.push_back(image);
+        }
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](bitmap a, bitmap b) {
+        return bitmap_height(a) > bitmap_height(b);
+    });
+
+    int shelf_x = ATLAS_PAGE_SIZE;
+    int shelf_y = 0;
+    int shelf_height = 0;
+
+    for (bitmap image : sorted) {
+        int width = bitmap_width(image) + ATLAS_PADDING * 2;
+        int height = bitmap_height(image) + ATLAS_PADDING * 2;
+
+        // Images larger than a page are left to draw from their own bitmap
+        if (width > ATLAS_PAGE_SIZE || height > ATLAS_PAGE_SIZE) {
+            continue;
+        }
+
+        // Start a new shelf when the image does not fit on this one
+        if (shelf_x + width > ATLAS_PAGE_SIZE) {
+            shelf_x = 0;
+            shelf_y += shelf_height;
+            shelf_height = 0;
+        }
+
+        // Start a new page when the shelf does not fit on this one
+        if (atlas_pages.empty() || shelf_y + height > ATLAS_PAGE_SIZE) {
+            std::string name = "atlas_page_" + std::to_string(atlas_pages.size());
+            atlas_pages.push_back(create_bitmap(name, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE));
+            shelf_x = 0;
+            shelf_y = 0;
+            shelf_height = 0;
+        }
+
+        int page = atlas_pages.size() - 1;
+        double x = shelf_x + ATLAS_PADDING;
+        double y = shelf_y + ATLAS_PADDING;
+        draw_bitmap_on_bitmap(atlas_pages[page], image, x, y);
+        atlas_regions[image] = { page, { x, y, static_cast<double>(bitmap_width(image)), static_cast<double>(bitmap_height(image)) } };
+
+        shelf_x += width;
+        shelf_height = std::max(shelf_height, height);
+    }
+}
+
+/**
+ * Returns where an image was packed.
+ *
+ * @param image The image.
+ * @return The image's region, or nullptr if it is not in the atlas.
+ */
+const atlas_region *atlas_find(bitmap image) {
+    auto found = atlas_regions.find(image);
+    return found != atlas_regions.end() ? &found->second : nullptr;
+}
+
+/**
+ * Returns the number of atlas pages.
+ *
+ * @return The page count.
+ */
+int atlas_page_count() {
+    return atlas_pages.size();
+}
+
+/**
+ * Queue a sprite's first layer to be drawn at the sprite's position and rotation.
+ *
+ * @param s The sprite.
+ * @param layer The draw layer.
+ */
+void queue_sprite_draw(sprite s, draw_layer layer) {
+    bitmap image = sprite_layer(s, 0);
+    rectangle whole = { 0, 0, static_cast<double>(bitmap_width(image)), static_cast<double>(bitmap_height(image)) };
+    queue_image_draw(image, whole, sprite_x(s), sprite_y(s), sprite_rotation(s), layer);
+}
+
+/**
+ * Queue a part of an image to be drawn, translated onto its atlas page when it is packed.
+ *
+ * @param image The image.
+ * @param part The part of the image to draw, in the image's own coordinates.
+ * @param x The x-coordinate to draw at.
+ * @param y The y-coordinate to draw at.
+ * @param angle The rotation in degrees.
+ * @param layer The draw layer.
+ */
+void queue_image_draw(bitmap image, const rectangle &part, double x, double y, double angle, draw_layer layer) {
+    const atlas_region *region = atlas_find(image);
+    if (region == nullptr) {
+        draw_batch.push_back({ layer, -1, image, part, x, y, angle });
+        return;
+    }
+
+    rectangle source = { region->source.x + part.x, region->source.y + part.y, part.width, part.height };
+    draw_batch.push_back({ layer, region->page, atlas_pages[region->page], source, x, y, angle });
+}
+
+/**
+ * Draw a part of an image now, from its atlas page when it is packed.
+ *
+ * @param image The image.
+ * @param part The part of the image to draw, in the image's own coordinates.
+ * @param x The x-coordinate to draw at.
+ * @param y The y-coordinate to draw at.
+ * @param opts The drawing options, e.g. option_to_screen().
+ */
+void draw_atlas_image(bitmap image, const rectangle &part, double x, double y, drawing_options opts) {
+    const atlas_region *region = atlas_find(image);
+    if (region == nullptr) {
+        draw_bitmap(image, x, y, option_part_bmp(part.x, part.y, part.width, part.height, opts));
+        return;
+    }
+
+    draw_bitmap(atlas_pages[region->page], x, y,
+                option_part_bmp(region->source.x + part.x, region->source.y + part.y, part.width, part.height, opts));
+}
+
+/**
+ * Draw every queued quad sorted by layer and then by atlas page, and empty the queue.
+ * The sort is stable, so quads of one layer and page keep the order they were queued in.
+ */
+void flush_draw_batch() {
+    std::stable_sort(draw_batch.begin(), draw_batch.end(), [](const draw_quad &a, const draw_quad &b) {
+        return a.layer != b.layer ? a.layer < b.layer : a.page < b.page;
+    });
+
+    for (const draw_quad &quad : draw_batch) {
+        drawing_options opts = option_part_bmp(quad.source.x, quad.source.y, quad.source.width, quad.source.height);
+        if (quad.angle != 0) {
+            opts = option_rotate_bmp(quad.angle, opts);
+        }
+        draw_bitmap(quad.texture, quad.x, quad.y, opts);
+    }
+
+    draw_batch.clear();
+}
@@ -0,0 +1,107 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include "platform.h"
+#include <vector>
+
+/**
+ * Texture atlas and ordered drawing.
+ *
+ * build_atlas packs the game's images into a few large page bitmaps when the
+ * resources are loaded. Entities are then not drawn one by one: their draw
+ * functions queue a quad (a part of an atlas page at a position and angle)
+ * and flush_draw_batch draws the queued quads sorted by draw layer and
+ * then by page, so consecutive draws use the same texture. SplashKit has no
+ * batch submission API, so each quad is still its own draw_bitmap call; the
+ * queue only cuts texture switches, not the per-call cost. Images missing
+ * from the atlas are still queued, drawn from their own bitmap.
+ */
+
+// Width and height of an atlas page in pixels
+const int ATLAS_PAGE_SIZE = 1024;
+
+// Empty pixels kept around each image so neighbours never bleed into it
+const int ATLAS_PADDING = 1;
+
+/**
+ * Draw layers of the batch, from back to front. The flush sorts on the
+ * layer first, so sorting by page never changes what is drawn on top.
+ */
+enum draw_layer {
+    LAYER_PLANETS,
+    LAYER_PLAYER,
+    LAYER_ENEMIES,
+    LAYER_POWER_UPS,
+    LAYER_EXPLOSIONS
+};
+
+/**
+ * Where an image was packed.
+ */
+struct atlas_region {
+    int page;           // Index of the atlas page
+    rectangle source;   // The image's rectangle on the page
+};
+
+/**
+ * Pack images into atlas pages by shelf packing, tallest first. Each page is
+ * a new bitmap the images are drawn onto. Calling it again replaces the atlas.
+ *
+ * @param images The images to pack; duplicates are packed once.
+ */
+void build_atlas(const std::vector<bitmap> &images);
+
+/**
+ * Returns where an image was packed.
+ *
+ * @param image The image.
+ * @return The image's region, or nullptr if it is not in the atlas.
+ */
+const atlas_region *atlas_find(bitmap image);
+
+/**
+ * Returns the number of atlas pages.
+ *
+ * @return The page count.
+ */
+int atlas_page_count();
+
+/**
+ * Queue a sprite's first layer to be drawn at the sprite's position and rotation.
+ *
+ * @param s The sprite.
+ * @param layer The draw layer.
+ */
+void queue_sprite_draw(sprite s, draw_layer layer);
+
+/**
+ * Queue a part of an image to be drawn.
+ *
+ * @param image The image.
+ * @param part The part of the image to draw, in the image's own coordinates.
+ * @param x The x-coordinate to draw at.
+ * @param y The y-coordinate to draw at.
+ * @param angle The rotation in degrees.
+ * @param layer The draw layer.
+ */
+void queue_image_draw(bitmap image, const rectangle &part, double x, double y, double angle, draw_layer layer);
+
+/**
+ * Draw a part of an image now, from its atlas page when it is packed.
+ *
+ * @param image The image.
+ * @param part The part of the image to draw, in the image's own coordinates.
+ * @param x The x-coordinate to draw at.
+ * @param y The y-coordinate to draw at.
+ * @param opts The drawing options, e.g. option_to_screen().
+ */
+void draw_atlas_image(bitmap image, const rectangle &part, double x, double y, drawing_options opts);
+
+/**
+ * Draw every queued quad sorted by layer and then by atlas page, and empty
+ * the queue. Each quad is one draw_bitmap call, as SplashKit cannot submit
+ * several at once.
+ */
+void flush_draw_batch();
+
+#endif // ATLAS_H
@@ -0,0 +1,116 @@
+#include "platform.h"
+#include "circle_batch.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Remove every circle from a batch, keeping its storage for reuse.
+ *
+ * @param batch The batch to clear.
+ */
+void clear_circle_batch(circle_batch_data &batch) {
+    batch.x.clear();
+    batch.y.clear();
+    batch.radius.clear();
+}
+
+/**
+ * Add a circle to the end of a batch.
+ *
+ * @param batch The batch to add to.
+ * @param shape The circle to add.
+ */
+void add_to_circle_batch(circle_batch_data &batch, const circle &shape) {
+    batch.x.push_back(shape.center.x);
+    batch.y.push_back(shape.center.y);
+    batch.radius.push_back(shape.radius);
+}
+
+/**
+ * Returns the number of circles in a batch.
+ *
+ * @param batch The batch.
+ * @return The number of circles.
+ */
+int circle_batch_size(const circle_batch_data &batch) {
+    return batch.x.size();
+}
+
+/**
+ * Test one circle against up to CIRCLE_BATCH_BLOCK consecutive circles of a batch.
+ * Each lane computes dx * dx + dy * dy <= (r1 + r2) * (r1 + r2), the same
+ * expression as circle_collision, so the vector and scalar paths agree exactly.
+ *
+ * @param shape The circle to test.
+ * @param batch The circles to test against.
+ * @param first The index of the first circle to test.
+ * @param count The number of circles to test, at most CIRCLE_BATCH_BLOCK.
+ * @return A mask with bit k set if shape collides with circle first + k.
+ */
+uint64_t circle_batch_collisions(const circle &shape, const circle_batch_data &batch, int first, int count) {
+    const double *x = batch.x.data() + first;
+    const double *y = batch.y.data() + first;
+    const double *radius = batch.radius.data() + first;
+    uint64_t mask = 0;
+    int i = 0;
+
+#if defined(__AVX2__)
+    __m256d center_x = _mm256_set1_pd(shape.center.x);
+    __m256d center_y = _mm256_set1_pd(shape.center.y);
+    __m256d shape_radius = _mm256_set1_pd(shape.radius);
+
+    for (; i + 4 <= count; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i), center_x);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i), center_y);
+        __m256d radius_sum = _mm256_add_pd(_mm256_loadu_pd(radius + i), shape_radius);
+        __m256d distance_squared = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        __m256d hit = _mm256_cmp_pd(distance_squared, _mm256_mul_pd(radius_sum, radius_sum), _CMP_LE_OQ);
+        mask |= static_cast<uint64_t>(_mm256_movemask_pd(hit)) << i;
+    }
+#elif defined(__SSE2__)
+    __m128d center_x = _mm_set1_pd(shape.center.x);
+    __m128d center_y = _mm_set1_pd(shape.center.y);
+    __m128d shape_radius = _mm_set1_pd(shape.radius);
+
+    for (; i + 2 <= count; i += 2) {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + i), center_x);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + i), center_y);
+        __m128d radius_sum = _mm_add_pd(_mm_loadu_pd(radius + i), shape_radius);
+        __m128d distance_squared = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        __m128d hit = _mm_cmple_pd(distance_squared, _mm_mul_pd(radius_sum, radius_sum));
+        mask |= static_cast<uint64_t>(_mm_movemask_pd(hit)) << i;
+    }
+#endif
+
+    // Scalar loop for the remainder, or for everything without SIMD
+    for (; i < count; i++) {
+        double dx = x[i] - shape.center.x;
+        double dy = y[i] - shape.center.y;
+        double radius_sum = radius[i] + shape.radius;
+        if (dx * dx + dy * dy <= radius_sum * radius_sum) {
+            mask |= uint64_t(1) << i;
+        }
+    }
+
+    return mask;
+}
+
+/**
+ * Returns the index of the highest bit set in a non-zero mask.
+ *
+ * @param mask The mask.
+ * @return The bit index, from 0 to 63.
+ */
+int highest_hit(uint64_t mask) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(mask);
+#else
+    int bit = 63;
+    while ((mask >> bit) == 0) {
+        bit--;
+    }
+    return bit;
+#endif
+}
@@ -0,0 +1,67 @@
+#ifndef CIRCLE_BATCH_H
+#define CIRCLE_BATCH_H
+
+#include "platform.h"
+#include <cstdint>
+
+// Largest number of circles one call to circle_batch_collisions can test
+const int CIRCLE_BATCH_BLOCK = 64;
+
+/**
+ * Circles packed as separate x, y and radius arrays so one circle can be
+ * tested against many at vector width.
+ *
+ * The kernel is chosen at compile time: AVX2 (4 doubles per step) when the
+ * compiler targets it, e.g. with -mavx2 or -march=native, otherwise SSE2
+ * (2 doubles per step), which every x86-64 compiler enables, otherwise a
+ * scalar loop. All three give the same results as circle_collision.
+ */
+struct circle_batch_data {
+    vector<double> x;       // Centre x of each circle
+    vector<double> y;       // Centre y of each circle
+    vector<double> radius;  // Radius of each circle
+};
+
+/**
+ * Remove every circle from a batch, keeping its storage for reuse.
+ *
+ * @param batch The batch to clear.
+ */
+void clear_circle_batch(circle_batch_data &batch);
+
+/**
+ * Add a circle to the end of a batch.
+ *
+ * @param batch The batch to add to.
+ * @param shape The circle to add.
+ */
+void add_to_circle_batch(circle_batch_data &batch, const circle &shape);
+
+/**
+ * Returns the number of circles in a batch.
+ *
+ * @param batch The batch.
+ * @return The number of circles.
+ */
+int circle_batch_size(const circle_batch_data &batch);
+
+/**
+ * Test one circle against up to CIRCLE_BATCH_BLOCK consecutive circles of a batch.
+ *
+ * @param shape The circle to test.
+ * @param batch The circles to test against.
+ * @param first The index of the first circle to test.
+ * @param count The number of circles to test, at most CIRCLE_BATCH_BLOCK.
+ * @return A mask with bit k set if shape collides with circle first + k.
+ */
+uint64_t circle_batch_collisions(const circle &shape, const circle_batch_data &batch, int first, int count);
+
+/**
+ * Returns the index of the highest bit set in a non-zero mask.
+ *
+ * @param mask The mask.
+ * @return The bit index, from 0 to 63.
+ */
+int highest_hit(uint64_t mask);
+
+#endif // CIRCLE_BATCH_H
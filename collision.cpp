@@ -1,18 +1,30 @@
-#include "splashkit.h"
+#include "platform.h"
 #include "collision.h"
+#include "profiler.h"
+#include "circle_batch.h"
+#include <algorithm>
 
 /**
  * Handle the collision between the player projectile and an enemy.
- * Reduces the enemy's health, removes the enemy if its health reaches zero,
+ * Reduces the enemy's health, destroys the enemy if its health reaches zero,
  * adds an explosion effect, increments the player's kill count, plays sound effects,
- * activates the ultimate kill streak if the kill count reaches 10, and removes the player projectile.
+ * activates the ultimate kill streak if the kill count reaches 10, and destroys the player projectile.
+ * Destroyed entities are removed at the end of the frame.
  *
  * @param game The game_data object containing the player, projectiles, enemies, and sound effects.
- * @param enemy The enemy_data object involved in the collision.
- * @param enemy_index The index of the enemy in the enemies vector.
- * @param projectile_index The index of the player projectile in the projectiles vector.
+ * @param enemy_handle The handle of the enemy involved in the collision.
+ * @param projectile_handle The handle of the player projectile.
  */
-void handle_enemy_collision(game_data &game, enemy_data &enemy, int enemy_index, int projectile_index) {
+void handle_enemy_collision(game_data &game, entity_handle enemy_handle, entity_handle projectile_handle) {
+    profile_scope scope(ZONE_HANDLE_ENEMY_COLLISION);
+
+    // Nothing to do if either side was destroyed earlier in the frame
+    int enemy_index = handle_index(game.enemy_handles, enemy_handle);
+    if (enemy_index < 0 || enemy_destroy_pending(game, enemy_index) || handle_index(game.projectiles.handles, projectile_handle) < 0) {
+        return;
+    }
+    enemy_data &enemy = game.enemies[enemy_index];
+
     // Play a sound effect for the collision
     play_sound_effect("hit");
     
@@ -24,8 +36,8 @@ void handle_enemy_collision(game_data &game, enemy_data &enemy, int enemy_index,
         // Add an explosion effect at the enemy's position
         add_explosion(game, sprite_x(enemy.enemy_sprite), sprite_y(enemy.enemy_sprite));
         
-        // Remove the enemy from the enemies vector
-        game.enemies.erase(game.enemies.begin() + enemy_index);
+        // Destroy the enemy at the end of the frame
+        destroy_enemy(game, enemy_handle);
         
         // Increment the player's kill count
         game.player.kill_count++;
@@ -38,36 +50,61 @@ void handle_enemy_collision(game_data &game, enemy_data &enemy, int enemy_index,
             activate_ultimate_kill_streak(game);
         }
         
-        // Remove the player projectile
-        game.projectiles.erase(game.projectiles.begin() + projectile_index);
+        // Destroy the player projectile
+        destroy_projectile(game.projectiles, projectile_handle);
     }
 }
 
+/**
+ * Load the enemies' collision circles into the game's enemy grid.
+ *
+ * @param game The game_data object containing the enemies and the grid.
+ */
+void rebuild_enemy_grid(game_data &game) {
+    spatial_grid_data &grid = game.enemy_grid;
+    grid.shapes.resize(game.enemies.size());
+    for (size_t j = 0; j < game.enemies.size(); j++) {
+        grid.shapes[j] = sprite_collision_circle(game.enemies[j].enemy_sprite);
+    }
+    rebuild_spatial_grid(grid);
+}
+
 /**
  * Check for collisions between the player's projectiles and enemies.
  * Calls the handle_enemy_collision function for each collision.
  *
+ * Each projectile is only tested against the enemies in the grid cells it can
+ * reach. Where it overlaps several enemies the highest-indexed one is hit, as
+ * when every enemy was scanned in reverse order. Killed enemies are removed
+ * from the grid so no later projectile hits them; they and the spent
+ * projectiles stay in their vectors until the end of the frame, so the
+ * indices used here remain valid.
+ *
  * @param game The game_data object containing the player, projectiles, and enemies.
  */
 void check_player_projectile_collisions(game_data &game) {
+    bool grid_built = false;
+
     // Loop through all projectiles in reverse order to handle collisions properly
-    for (int i = game.projectiles.size() - 1; i >= 0; i--) {
-        // Get a reference to the current projectile
-        projectile_data &projectile = game.projectiles[i];
-        
-        // Check if the projectile was fired by the player
-        if (projectile.owner == 0) {
-            // Loop through all enemies in reverse order to handle collisions properly
-            for (int j = game.enemies.size() - 1; j >= 0; j--) {
-                // Get a reference to the current enemy
-                enemy_data &enemy = game.enemies[j];
-                
-                // Check for collision between the player projectile and the enemy
-                if (circle_collision(projectile.shape, sprite_collision_circle(enemy.enemy_sprite))) {
-                    // Handle the collision between the player projectile and the enemy
-                    handle_enemy_collision(game, enemy, j, i);
-                    break;
-                }
+    for (int i = projectile_count(game.projectiles) - 1; i >= 0; i--) {
+        // Check if the projectile was fired by the player and is still live
+        if (game.projectiles.owner[i] != 0 || projectile_destroy_pending(game.projectiles, i)) {
+            continue;
+        }
+
+        // Only build the grid once there is a player projectile to test
+        if (!grid_built) {
+            rebuild_enemy_grid(game);
+            grid_built = true;
+        }
+
+        int j = spatial_grid_last_hit(game.enemy_grid, projectile_shape(game.projectiles, i));
+        if (j >= 0) {
+            // Handle the collision between the player projectile and the enemy
+            handle_enemy_collision(game, game.enemies[j].handle, handle_at(game.projectiles.handles, i));
+
+            if (enemy_destroy_pending(game, j)) {
+                spatial_grid_remove(game.enemy_grid, j);
             }
         }
     }
@@ -77,12 +114,22 @@ void check_player_projectile_collisions(game_data &game) {
 /**
  * Handle the collision between a projectile and the player.
  * Plays a sound effect, reduces player's shield or fuel percentage based on the collision result,
- * checks if the player's fuel percentage has reached zero, and removes the projectile.
+ * checks if the player's fuel percentage has reached zero, and destroys the projectile.
+ * The fuel damage is the current damage value of the enemy that fired the projectile,
+ * or the value it had when it fired if that enemy has since been destroyed.
  *
  * @param game The game_data object containing the player, projectiles, and enemies.
- * @param i The index of the projectile involved in the collision.
+ * @param projectile_handle The handle of the projectile involved in the collision.
  */
-void handle_projectile_collision(game_data &game, int i) {
+void handle_projectile_collision(game_data &game, entity_handle projectile_handle) {
+    profile_scope scope(ZONE_HANDLE_PROJECTILE_COLLISION);
+
+    // Nothing to do if the projectile was destroyed earlier in the frame
+    int i = handle_index(game.projectiles.handles, projectile_handle);
+    if (i < 0 || projectile_destroy_pending(game.projectiles, i)) {
+        return;
+    }
+
     // Play a sound effect for the collision
     play_sound_effect("hit");
     
@@ -91,8 +138,9 @@ void handle_projectile_collision(game_data &game, int i) {
         // Reduce the player's shield percentage by 0.25
         game.player.shield_pct -= 0.15;
     } else {
-        // Reduce the player's fuel percentage by the damage value of the enemy projectile
-        game.player.fuel_pct -= game.enemies[i].damage_value;
+        // Reduce the player's fuel percentage by the damage value of the enemy that fired the projectile
+        int source = handle_index(game.enemy_handles, game.projectiles.source[i]);
+        game.player.fuel_pct -= source >= 0 ? game.enemies[source].damage_value : game.projectiles.damage[i];
     }
     
     // Check if the player's fuel percentage has reached zero
@@ -101,8 +149,8 @@ void handle_projectile_collision(game_data &game, int i) {
         game_over(game);
     }
     
-    // Remove the projectile from the projectiles vector
-    game.projectiles.erase(game.projectiles.begin() + i);
+    // Destroy the projectile
+    destroy_projectile(game.projectiles, projectile_handle);
 }
 
 /**
@@ -112,13 +160,24 @@ void handle_projectile_collision(game_data &game, int i) {
  * @param game The game_data object containing the player, projectiles, and enemies.
  */
 void check_enemy_projectile_collisions(game_data &game) {
-    // Iterate over the projectiles in reverse order to handle collisions properly
-    for (int i = game.projectiles.size() - 1; i >= 0; i--) {
-        // Check if the projectile belongs to the enemy and collides with the player
-        if (game.projectiles[i].owner == 1 &&
-            circle_collision(game.projectiles[i].shape, sprite_collision_circle(game.player.player_sprite))) {
-            // Handle the collision between the projectile and the player
-            handle_projectile_collision(game, i);
+    // The pool's shapes are already packed, so the player is tested against a block at a time
+    const circle_batch_data &batch = game.projectiles.shapes;
+    circle player_circle = sprite_collision_circle(game.player.player_sprite);
+
+    // Iterate over the blocks, and the hits within each, in reverse order to handle collisions properly
+    for (int first = (circle_batch_size(batch) - 1) / CIRCLE_BATCH_BLOCK * CIRCLE_BATCH_BLOCK; first >= 0; first -= CIRCLE_BATCH_BLOCK) {
+        int count = std::min(CIRCLE_BATCH_BLOCK, circle_batch_size(batch) - first);
+        uint64_t hits = circle_batch_collisions(player_circle, batch, first, count);
+
+        while (hits != 0) {
+            int bit = highest_hit(hits);
+            hits &= ~(uint64_t(1) << bit);
+
+            // Check if the projectile belongs to the enemy
+            if (game.projectiles.owner[first + bit] == 1) {
+                // Handle the collision between the projectile and the player
+                handle_projectile_collision(game, handle_at(game.projectiles.handles, first + bit));
+            }
         }
     }
 }
@@ -184,9 +243,10 @@ void check_collisions(game_data &game) {
  */
 bool circle_collision(const circle &c1, const circle &c2) {
     // Calculate the distance between the centers of the circles squared
-    float distance_squared = pow(c1.center.x - c2.center.x, 2) + pow(c1.center.y - c2.center.y, 2);
+    double dx = c1.center.x - c2.center.x;
+    double dy = c1.center.y - c2.center.y;
     // Calculate the sum of the radii of the circles
-    float radius_sum = c1.radius + c2.radius;
+    double radius_sum = c1.radius + c2.radius;
     // Check if the distance squared is less than or equal to the squared radius sum
-    return distance_squared <= pow(radius_sum, 2);
-}
\ No newline at end of file
+    return dx * dx + dy * dy <= radius_sum * radius_sum;
+}
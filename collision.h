@@ -8,13 +8,20 @@
 
 /**
  * Handle the collision between an enemy and a player projectile.
+ * A killed enemy and the projectile are destroyed, and removed at the end of the frame.
  *
  * @param game The game_data object containing the player, projectiles, enemies, and sound effects.
- * @param enemy The enemy_data object involved in the collision.
- * @param enemy_index The index of the enemy in the enemies vector.
- * @param projectile_index The index of the player projectile in the projectiles vector.
+ * @param enemy_handle The handle of the enemy involved in the collision.
+ * @param projectile_handle The handle of the player projectile.
  */
-void handle_enemy_collision(game_data &game, enemy_data &enemy, int enemy_index, int projectile_index);
+void handle_enemy_collision(game_data &game, entity_handle enemy_handle, entity_handle projectile_handle);
+
+/**
+ * Load the enemies' collision circles into the game's enemy grid.
+ *
+ * @param game The game_data object containing the enemies and the grid.
+ */
+void rebuild_enemy_grid(game_data &game);
 
 /**
  * Check for collisions between the player's projectiles and enemies.
@@ -27,12 +34,12 @@ void check_player_projectile_collisions(game_data &game);
 /**
  * Handle the collision between a projectile and the player.
  * Updates player's shield or fuel percentage based on the collision result,
- * checks if the player's fuel percentage has reached zero, and removes the projectile.
+ * checks if the player's fuel percentage has reached zero, and destroys the projectile.
  *
  * @param game The game_data object containing the player, projectiles, and enemies.
- * @param i The index of the projectile involved in the collision.
+ * @param projectile_handle The handle of the projectile involved in the collision.
  */
-void handle_projectile_collision(game_data &game, int i);
+void handle_projectile_collision(game_data &game, entity_handle projectile_handle);
 
 /**
  * Check for collisions between enemy projectiles and the player.
@@ -1,11 +1,17 @@
-#include "splashkit.h"
+#include "platform.h"
+#include "atlas.h"
 #include "enemy.h"
+#include "sprites.h"
+#include "game_data.h"
+#include "entity_container.h"
+#include <algorithm>
 
 // Constant for projectile firing interval
 const int PROJECTILE_FIRE_INTERVAL = 2000; // 2 seconds in milliseconds
 const double COLLISION_DISTANCE = 20.0; // Distance to detect potential collisions
 const double MINIMUM_DISTANCE = 200.0;
 const double STOP_DISTANCE = 200.0; // Add this constant at the beginning of your file
+const unsigned int WANDER_INTERVAL = 2000; // 2 seconds in milliseconds
 
 /**
  * This returns the bitmap associated with a specific enemy kind.
@@ -84,15 +90,19 @@ void sprite_turn_to_face(sprite s, point_2d target) {
  * @param kind The kind of enemy to create.
  * @param player The player_data object containing player-related information.
  * @param enemies The vector of enemy_data objects containing existing enemy data.
+ * @param rng The random number stream used to place the enemy.
  * @return The newly created enemy_data object.
  */
-enemy_data new_enemy(enemy_kind kind, const player_data &player, const vector<enemy_data> &enemies) {
+enemy_data new_enemy(enemy_kind kind, const player_data &player, const vector<enemy_data> &enemies, rng_data &rng) {
     enemy_data result;
     bitmap default_bitmap = enemy_bitmap(kind);
 
-    result.enemy_sprite = create_sprite(default_bitmap);
+    result.enemy_sprite = owned_sprite(default_bitmap);
     result.kind = kind;
     result.last_projectile_tick = 0;
+    result.state = IDLE;
+    result.attack_start_time = 0.0;
+    result.handle = NULL_HANDLE;
 
     // Define a struct to hold the attributes for each enemy type
     struct enemy_attributes {
@@ -118,15 +128,20 @@ enemy_data new_enemy(enemy_kind kind, const player_data &player, const vector<en
     result.damage_value = enemy_type_attributes[kind].damage_value;
     result.type = enemy_type_attributes[kind].type;
 
+    // Pack the other enemies' centres once for every position tried
+    circle_batch_data enemy_centers;
+    pack_enemy_centers(enemies, enemy_centers);
+
     // Generate a random position and check if it's safe
     point_2d position;
     do {
-        position.x = rnd(screen_width());
-        position.y = rnd(screen_height());
-    } while (!is_safe_distance_from_player(position, player.player_sprite) || !is_safe_distance_from_enemies(position, enemies));
+        position.x = rng_int(rng, screen_width());
+        position.y = rng_int(rng, screen_height());
+    } while (!is_safe_distance_from_player(position, player.player_sprite) || !is_safe_distance_from_enemies(position, enemy_centers));
 
     sprite_set_position(result.enemy_sprite, position);
-    sprite_set_rotation(result.enemy_sprite, rnd(360));
+    sprite_set_rotation(result.enemy_sprite, rng_int(rng, 360));
+    result.previous_position = position;
 
     return result;
 }
@@ -155,27 +170,58 @@ bool is_safe_distance_from_player(point_2d position, sprite player_sprite, doubl
  * @return True if the position is at a safe distance from other enemies, false otherwise.
  */
 bool is_safe_distance_from_enemies(point_2d position, const vector<enemy_data> &enemies, double min_distance) {
+    circle_batch_data enemy_centers;
+    pack_enemy_centers(enemies, enemy_centers);
+    return is_safe_distance_from_enemies(position, enemy_centers, min_distance);
+}
+
+/**
+ * Check if the specified position is at a safe distance from packed enemy centres.
+ * A zero-radius circle per enemy is tested against a circle of the minimum
+ * distance around the position, a block of enemies at a time.
+ *
+ * @param position The position to check.
+ * @param enemy_centers The enemies' centres, packed by pack_enemy_centers.
+ * @param min_distance The minimum safe distance.
+ * @return True if the position is at a safe distance from every enemy, false otherwise.
+ */
+bool is_safe_distance_from_enemies(point_2d position, const circle_batch_data &enemy_centers, double min_distance) {
     min_distance = 200;
-    for (const enemy_data &enemy : enemies) {
-        double distance = point_point_distance(position, sprite_center_point(enemy.enemy_sprite));
-        if (distance <= min_distance) {
+    circle safe_area = { position, min_distance };
+    for (int first = 0; first < circle_batch_size(enemy_centers); first += CIRCLE_BATCH_BLOCK) {
+        int count = std::min(CIRCLE_BATCH_BLOCK, circle_batch_size(enemy_centers) - first);
+        if (circle_batch_collisions(safe_area, enemy_centers, first, count) != 0) {
             return false;
         }
     }
     return true;
 }
 
+/**
+ * Pack the centres of enemies as zero-radius circles.
+ *
+ * @param enemies The enemies.
+ * @param enemy_centers The batch to fill; any previous contents are replaced.
+ */
+void pack_enemy_centers(const vector<enemy_data> &enemies, circle_batch_data &enemy_centers) {
+    clear_circle_batch(enemy_centers);
+    for (const enemy_data &enemy : enemies) {
+        add_to_circle_batch(enemy_centers, { sprite_center_point(enemy.enemy_sprite), 0.0 });
+    }
+}
+
 /**
  * Update the state of an enemy based on its distance from the player.
  *
  * @param enemy The enemy_data object to update.
  * @param player The player_data object containing player-related information.
+ * @param rng The random number stream used for the state switch.
  */
-void update_enemy_state(enemy_data& enemy, const player_data& player) {
+void update_enemy_state(enemy_data& enemy, const player_data& player, rng_data& rng) {
     double distance_to_player = point_point_distance(sprite_center_point(enemy.enemy_sprite), sprite_center_point(player.player_sprite));
 
     if (distance_to_player < 300) {
-        if (rnd(100) < 30) { // 30% chance to switch between ATTACK and CHASE states
+        if (rng_int(rng, 100) < 30) { // 30% chance to switch between ATTACK and CHASE states
             enemy.state = (enemy.state == ATTACK) ? CHASE : ATTACK;
         }
     } else {
@@ -243,8 +289,8 @@ void update_enemy_position(enemy_data& enemy, const player_data& player, game_da
             new_x = sprite_x(enemy.enemy_sprite) + dx;
             new_y = sprite_y(enemy.enemy_sprite) + dy;
 
-            // Create enemy projectiles if in ATTACK state and no existing projectiles
-            if (enemy.state == ATTACK && enemy.projectiles.empty()) {
+            // Create enemy projectiles if in ATTACK state
+            if (enemy.state == ATTACK) {
                 create_enemy_projectile(game, game.player, enemy);
             }
             break;
@@ -336,7 +382,7 @@ void update_enemy_collision(enemy_data& enemy, const player_data& player) {
  * @param game The game_data object containing game-related information.
  */
 void update_enemy_rotation(enemy_data& enemy, const player_data& player, game_data& game) {
-    double adjusted_rotation_speed = enemy.rotation_speed * (1.0 - (enemy.distance_to_player / 600.0)) + (rnd(3) - 1);
+    double adjusted_rotation_speed = enemy.rotation_speed * (1.0 - (enemy.distance_to_player / 600.0)) + (rng_int(game.rng, 3) - 1);
     double rotation_step;
 
     switch (enemy.state) {
@@ -352,12 +398,9 @@ void update_enemy_rotation(enemy_data& enemy, const player_data& player, game_da
         case PATROL:
         case IDLE:
             // Add a wandering behaviour, causing the enemy to change direction periodically
-            static unsigned int wander_timer = 0;
-            static unsigned int wander_interval = 2000; // 2 seconds in milliseconds
-
-            if (timer_ticks(game.game_timer) - wander_timer >= wander_interval) {
-                wander_timer = timer_ticks(game.game_timer);
-                double random_angle = rnd(360);
+            if (game_clock_ticks(game.clock) - game.last_wander_tick >= WANDER_INTERVAL) {
+                game.last_wander_tick = game_clock_ticks(game.clock);
+                double random_angle = rng_int(game.rng, 360);
                 sprite_set_rotation(enemy.enemy_sprite, random_angle);
             }
             break;
@@ -376,7 +419,7 @@ void update_enemy_rotation(enemy_data& enemy, const player_data& player, game_da
  */
 void update_enemy(enemy_data& enemy, const player_data& player, game_data& game) {
     // Update the enemy's state to reflect the current state of the player.
-    update_enemy_state(enemy, player);
+    update_enemy_state(enemy, player, game.rng);
 
     // Adjust the enemy's orientation to face the player.
     update_enemy_orientation(enemy, player);
@@ -400,39 +443,27 @@ void update_enemy(enemy_data& enemy, const player_data& player, game_data& game)
     update_sprite(enemy.enemy_sprite);
 }
 
-/**
- * This function updates the projectiles in the game.
- * It iterates over each projectile in the vector and updates them with a time interval of 1/60 seconds.
- * 
- * @param projectiles The vector of projectiles to update.
- */
-void update_enemies_projectiles(std::vector<projectile_data>& projectiles) {
-    // Iterate over each projectile in the vector.
-    for (projectile_data& projectile : projectiles) {
-        // Update the individual projectile with a time interval of 1/60 seconds.
-        update_projectile(projectile, 1.0 / 60.0);
-    }
-}
-
 /**
  * This function updates the enemies in the game.
- * It iterates over each enemy in the game's enemies vector, updates their behaviour based on the player and game data,
- * updates their projectiles, and creates a new projectile if enough time has passed since the last one was fired.
+ * It iterates over each live enemy in the game's enemies vector, updates their behaviour based on the player and game data,
+ * and creates a new projectile if enough time has passed since the last one was fired.
  * 
  * @param game The game data.
  */
 void update_enemies(game_data& game) {
     // Iterate over each enemy in the game's enemies vector.
     for (size_t i = 0; i < game.enemies.size(); ++i) {
+        // Skip enemies killed earlier in the frame.
+        if (enemy_destroy_pending(game, i)) {
+            continue;
+        }
+
         // Get a reference to the current enemy.
         enemy_data& enemy = game.enemies[i];
 
         // Update the behaviour of the enemy based on the player and game data.
         update_enemy(enemy, game.player, game);
 
-        // Update the projectiles belonging to the enemy.
-        update_enemies_projectiles(enemy.projectiles);
-
         // Create a new projectile if enough time has passed since the last one was fired.
         create_enemy_projectile(game, game.player, enemy);
     }
@@ -440,20 +471,15 @@ void update_enemies(game_data& game) {
 
 
 /**
- * This function draws all the enemies in the game.
- * It iterates over each enemy in the game's enemies vector and draws their sprites.
- * It also draws the projectiles belonging to each enemy.
+ * This function draws the visible enemies in the game.
+ * It iterates over the indices of the enemies in view and draws their sprites.
  * 
  * @param game The game data.
+ * @param visible The indices of the enemies to draw, from cull_to_view.
  */
-void draw_enemies(const game_data& game) {
-    // Iterate over each enemy in the game's enemies vector.
-    for (const enemy_data& enemy : game.enemies) {
-        // Draw the enemy's sprite.
-        draw_sprite(enemy.enemy_sprite);
-
-        // Draw the projectiles belonging to the enemy.
-        draw_enemies_projectiles(enemy.projectiles);
+void draw_enemies(const game_data& game, const vector<int>& visible) {
+    for (int index : visible) {
+        draw_enemy(game.enemies[index]);
     }
 }
 
@@ -464,8 +490,8 @@ void draw_enemies(const game_data& game) {
  * @param enemy The enemy data.
  */
 void draw_enemy(const enemy_data& enemy) {
-    // Draw the enemy's sprite.
-    draw_sprite(enemy.enemy_sprite);
+    // Queue the enemy's sprite to be drawn.
+    queue_sprite_draw(enemy.enemy_sprite, LAYER_ENEMIES);
 }
 
 /**
@@ -476,25 +502,10 @@ void draw_enemy(const enemy_data& enemy) {
  */
 void spawn_all_enemies(game_data& game) {
     // Spawn new enemies and add them to the game's enemies vector.
-    game.enemies.push_back(new_enemy(enemy_kind::ENEMY_TYPE1, game.player, game.enemies));
-    game.enemies.push_back(new_enemy(enemy_kind::ENEMY_TYPE2, game.player, game.enemies));
-    game.enemies.push_back(new_enemy(enemy_kind::ENEMY_TYPE3, game.player, game.enemies));
-    game.enemies.push_back(new_enemy(enemy_kind::ENEMY_BOSS, game.player, game.enemies));
-}
-
-
-/**
- * This function draws all the projectiles in the game.
- * It iterates over each projectile in the given vector and draws them using the `draw_projectile` function.
- * 
- * @param projectiles The vector of projectile data.
- */
-void draw_enemies_projectiles(const std::vector<projectile_data>& projectiles) {
-    // Iterate over each projectile in the vector.
-    for (const projectile_data& projectile : projectiles) {
-        // Draw the individual projectile.
-        draw_projectile(projectile);
-    }
+    insert_enemy(game, new_enemy(enemy_kind::ENEMY_TYPE1, game.player, game.enemies, game.rng));
+    insert_enemy(game, new_enemy(enemy_kind::ENEMY_TYPE2, game.player, game.enemies, game.rng));
+    insert_enemy(game, new_enemy(enemy_kind::ENEMY_TYPE3, game.player, game.enemies, game.rng));
+    insert_enemy(game, new_enemy(enemy_kind::ENEMY_BOSS, game.player, game.enemies, game.rng));
 }
 
 
@@ -503,11 +514,12 @@ void draw_enemies_projectiles(const std::vector<projectile_data>& projectiles) {
  * It generates a random number between 0 and 1, and if the number is greater than 0.5,
  * it sets the delay multiplier to 2.0; otherwise, it remains as 1.0.
  * 
+ * @param rng The random number stream to draw from.
  * @return The calculated delay multiplier.
  */
-double calculate_delay() {
+double calculate_delay(rng_data& rng) {
     double delay_multiplier = 1.0;
-    double random_num = static_cast<double>(rand()) / RAND_MAX;
+    double random_num = rng_double(rng);
 
     // Check if the random number is greater than 0.5.
     if (random_num > 0.5) {
@@ -573,7 +585,7 @@ projectile_data create_projectile(const point_2d& position, double angle) {
  * It checks if enough time has passed since the attack started, accounting for the delay.
  * If enough time has passed, the function retrieves the position of the enemy's sprite and the center point of the player's sprite.
  * It calculates the angle (in degrees) between the enemy and the player.
- * Using the position and angle, the function creates a new projectile and adds it to the game's projectiles vector.
+ * Using the position and angle, the function creates a new projectile and adds it to the game's projectile pool.
  * The tick when the projectile was fired is recorded, and a sound effect for the projectile is played.
  * Finally, the attack start time is reset.
  * 
@@ -583,19 +595,19 @@ projectile_data create_projectile(const point_2d& position, double angle) {
  */
 void create_enemy_projectile(game_data &game, const player_data& player, enemy_data& enemy) {
     // Calculate the time since the last projectile was fired.
-    double time_since_last_projectile = timer_ticks(game.game_timer) - enemy.last_projectile_tick;
+    double time_since_last_projectile = game_clock_ticks(game.clock) - enemy.last_projectile_tick;
 
     // Check if the enemy is in the ATTACK state and enough time has passed since the last projectile.
     if (enemy.state == ATTACK && time_since_last_projectile >= PROJECTILE_FIRE_INTERVAL) {
         // If the attack just started, record the start time and return (don't shoot yet).
         if (enemy.attack_start_time == 0.0) {
-            enemy.attack_start_time = timer_ticks(game.game_timer);
+            enemy.attack_start_time = game_clock_ticks(game.clock);
             return;
         }
 
         // Calculate the time since the attack started and apply the delay multiplier.
-        double time_since_attack_start = timer_ticks(game.game_timer) - enemy.attack_start_time;
-        double delay_multiplier = calculate_delay();
+        double time_since_attack_start = game_clock_ticks(game.clock) - enemy.attack_start_time;
+        double delay_multiplier = calculate_delay(game.rng);
 
         // Check if enough time has passed since the attack started (accounting for delay).
         if (time_since_attack_start < 1000 * delay_multiplier) {
@@ -610,13 +622,16 @@ void create_enemy_projectile(game_data &game, const player_data& player, enemy_d
         double angle_degrees = calculate_angle(enemy_circle_point, player_center);
 
         // Create a new projectile with the enemy's position and calculated angle.
+        // It keeps the enemy's handle so a hit applies the enemy's current damage.
         projectile_data new_projectile = create_projectile(enemy_circle_point, angle_degrees);
+        new_projectile.source = enemy.handle;
+        new_projectile.damage = enemy.damage_value;
 
-        // Add the new projectile to the game's projectiles vector.
-        game.projectiles.push_back(new_projectile);
+        // Add the new projectile to the game's projectile pool.
+        add_projectile(game.projectiles, new_projectile);
 
         // Record the tick when the projectile was fired.
-        enemy.last_projectile_tick = timer_ticks(game.game_timer);
+        enemy.last_projectile_tick = game_clock_ticks(game.clock);
 
         // Play a sound effect for the projectile.
         play_sound_effect("laser");
@@ -625,3 +640,58 @@ void create_enemy_projectile(game_data &game, const player_data& player, enemy_d
         enemy.attack_start_time = 0.0;
     }
 }
+
+/**
+ * This function adds an enemy to the game and gives it a handle.
+ *
+ * @param game The game data.
+ * @param enemy The enemy to add, moved into the vector.
+ * @return The enemy's handle.
+ */
+entity_handle insert_enemy(game_data &game, enemy_data enemy) {
+    game.enemies.push_back(std::move(enemy));
+    game.enemies.back().handle = handle_table_add(game.enemy_handles);
+    return game.enemies.back().handle;
+}
+
+/**
+ * This function queues an enemy to be removed at the end of the frame.
+ *
+ * @param game The game data.
+ * @param enemy The enemy's handle.
+ */
+void destroy_enemy(game_data &game, entity_handle enemy) {
+    handle_table_destroy_later(game.enemy_handles, enemy);
+}
+
+/**
+ * This function checks whether the enemy at an index has been destroyed this frame.
+ *
+ * @param game The game data.
+ * @param index The enemy's index in the enemies vector.
+ * @return True if the enemy is waiting to be removed, false otherwise.
+ */
+bool enemy_destroy_pending(const game_data &game, int index) {
+    return index_destroy_pending(game.enemy_handles, index);
+}
+
+/**
+ * This function removes every enemy queued by destroy_enemy, returning its sprite.
+ *
+ * @param game The game data.
+ */
+void flush_destroyed_enemies(game_data &game) {
+    flush_destroyed_entities(game.enemy_handles, [&](int index) {
+        swap_remove(game.enemies, index);
+    });
+}
+
+/**
+ * This function removes every enemy from the game, returning their sprites.
+ *
+ * @param game The game data.
+ */
+void clear_enemies(game_data &game) {
+    game.enemies.clear();
+    game.enemy_handles = handle_table_data();
+}
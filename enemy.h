@@ -1,10 +1,14 @@
 #ifndef ENEMY_H
 #define ENEMY_H
 
-#include "splashkit.h"
+#include "platform.h"
+#include "sprites.h"
 #include "lost_in_space.h"
 #include "shooting.h"
 #include "player.h"
+#include "rng.h"
+#include "circle_batch.h"
+#include "handle_table.h"
 #include <vector>
 
 // Forward declaration of the game_data struct
@@ -36,7 +40,7 @@ enum enemy_state {
 
 // This struct represents the data and properties of an enemy character in the game.
 struct enemy_data {
-    sprite enemy_sprite;                   // The sprite representing the enemy.
+    owned_sprite enemy_sprite;             // The sprite representing the enemy.
     enemy_kind kind;                       // The type or kind of enemy.
     int last_projectile_tick;              // The tick count when the last projectile was fired.
     int health;                            // The current health of the enemy.
@@ -44,7 +48,6 @@ struct enemy_data {
     double rotation_speed;                 // The rotation speed of the enemy.
     enemy_state state;                     // The state or behaviour of the enemy.
     double attack_start_time;              // The time when the attack started.
-    std::vector<projectile_data> projectiles;  // A vector of projectiles fired by the enemy.
     circle shape;                          // The shape or hitbox of the enemy.
     damage_type type;                      // The type of damage inflicted by the enemy.
     float damage_value;                     // The value or amount of damage inflicted by the enemy.
@@ -55,8 +58,18 @@ struct enemy_data {
     double new_x;                           // The new x-coordinate of the enemy after an update.
     double new_y;                           // The new y-coordinate of the enemy after an update.
     double adjusted_speed;                  // The adjusted speed of the enemy based on player speed.
+    entity_handle handle;                   // The enemy's handle in the game's enemy table.
+    point_2d previous_position;             // The sprite position before the last simulation step, for interpolation.
 };
 
+/**
+ * This returns the bitmap associated with a specific enemy kind.
+ *
+ * @param kind The kind of enemy to get the bitmap for.
+ * @return The bitmap associated with the specified enemy kind.
+ */
+bitmap enemy_bitmap(enemy_kind kind);
+
 /**
  * This function creates a new enemy with the specified kind and initializes its properties.
  * It takes the enemy kind, player data, and a vector of existing enemies as input.
@@ -67,9 +80,10 @@ struct enemy_data {
  * @param kind The kind of enemy to create.
  * @param player The player data.
  * @param enemies The vector of existing enemies.
+ * @param rng The random number stream used to place the enemy.
  * @return The newly created enemy.
  */
-enemy_data new_enemy(enemy_kind kind, const player_data &player, const vector<enemy_data> &enemies);
+enemy_data new_enemy(enemy_kind kind, const player_data &player, const vector<enemy_data> &enemies, rng_data &rng);
 
 /**
  * This function checks if a given position is a safe distance away from the player.
@@ -98,6 +112,27 @@ bool is_safe_distance_from_player(point_2d position, sprite player_sprite, doubl
  */
 bool is_safe_distance_from_enemies(point_2d position, const vector<enemy_data> &enemies, double min_distance = 200);
 
+/**
+ * This function checks if a given position is a safe distance away from enemy centres
+ * already packed by pack_enemy_centers, using the batched circle collision kernel.
+ * Use it when several positions are checked against the same enemies.
+ *
+ * @param position The position to check.
+ * @param enemy_centers The packed centres of the existing enemies.
+ * @param min_distance The minimum distance (default: 200).
+ * @return True if the position is a safe distance from all other enemies, false otherwise.
+ */
+bool is_safe_distance_from_enemies(point_2d position, const circle_batch_data &enemy_centers, double min_distance = 200);
+
+/**
+ * This function packs the centre points of the enemies' sprites as zero-radius circles
+ * for is_safe_distance_from_enemies.
+ *
+ * @param enemies The vector of existing enemies.
+ * @param enemy_centers The batch to fill; its previous contents are replaced.
+ */
+void pack_enemy_centers(const vector<enemy_data> &enemies, circle_batch_data &enemy_centers);
+
 /**
  * This function updates the orientation of the enemy to face the player.
  * It takes the enemy data and player data as input.
@@ -183,7 +218,7 @@ void update_enemy_rotation(enemy_data& enemy, const player_data& player, game_da
  * This function updates all enemies in the game.
  * It takes the game data as input.
  * The function iterates over each enemy in the game's enemies vector and calls the update_enemy function
- * to update the behaviour and properties of each enemy. It also updates the projectiles belonging to each enemy.
+ * to update the behaviour and properties of each enemy.
  *
  * @param game The game data.
  */
@@ -199,14 +234,14 @@ void update_enemies(game_data& game);
 void draw_enemy(const enemy_data &enemy);
 
 /**
- * This function draws all enemies on the screen.
- * It takes the game data as input.
- * The function iterates over each enemy in the game's enemies vector and calls the draw_enemy function
- * to draw each enemy on the screen.
+ * This function draws the visible enemies on the screen.
+ * It takes the game data and the indices of the enemies in view as input,
+ * and calls the draw_enemy function for each of those enemies.
  *
  * @param game The game data.
+ * @param visible The indices of the enemies to draw, from cull_to_view.
  */
-void draw_enemies(const game_data &game);
+void draw_enemies(const game_data &game, const vector<int> &visible);
 
 /**
  * This function spawns all enemies in the game, either by creating new ones or respawning dead ones.
@@ -223,7 +258,7 @@ void spawn_all_enemies(game_data& game);
  * It takes the game data, player data, and enemy data as input.
  * The function checks the state of the enemy and the time since the last projectile was fired.
  * If the conditions are met, it calculates the position and angle for the new projectile and creates it.
- * The projectile is then added to the game's projectiles vector.
+ * The projectile is then added to the game's projectile pool.
  *
  * @param game The game data.
  * @param player The player data.
@@ -232,24 +267,47 @@ void spawn_all_enemies(game_data& game);
 void create_enemy_projectile(game_data &game, const player_data& player, enemy_data& enemy);
 
 /**
- * This function updates the behaviour and properties of projectiles.
- * It takes the vector of projectiles as input.
- * The function iterates over each projectile in the vector and calls the update_projectile function
- * to update the movement and lifetime of each projectile.
+ * This function adds an enemy to the game and gives it a handle.
+ * Every enemy in the game's enemies vector is added through here, so the
+ * vector and the game's enemy handle table stay in step.
  *
- * @param projectiles The vector of projectiles.
+ * @param game The game data.
+ * @param enemy The enemy to add, moved into the vector.
+ * @return The enemy's handle.
+ */
+entity_handle insert_enemy(game_data &game, enemy_data enemy);
+
+/**
+ * This function queues an enemy to be removed at the end of the frame.
+ * Until then it stays in the enemies vector, but is skipped by update_enemies.
+ *
+ * @param game The game data.
+ * @param enemy The enemy's handle.
+ */
+void destroy_enemy(game_data &game, entity_handle enemy);
+
+/**
+ * This function checks whether the enemy at an index has been destroyed this frame.
+ *
+ * @param game The game data.
+ * @param index The enemy's index in the enemies vector.
+ * @return True if the enemy is waiting to be removed, false otherwise.
  */
-void update_enemies_projectiles(std::vector<projectile_data>& projectiles);
+bool enemy_destroy_pending(const game_data &game, int index);
 
 /**
- * This function draws the visual representation of projectiles on the screen.
- * It takes the vector of projectiles as input.
- * The function iterates over each projectile in the vector and calls the draw_projectile function
- * to draw each projectile on the screen.
+ * This function removes every enemy queued by destroy_enemy and returns its sprite to the pool.
+ * The last enemy moves into each freed index.
  *
- * @param projectiles The vector of projectiles.
+ * @param game The game data.
  */
-void draw_enemies_projectiles(const std::vector<projectile_data>& projectiles);
+void flush_destroyed_enemies(game_data &game);
 
+/**
+ * This function removes every enemy from the game and returns their sprites to the pool.
+ *
+ * @param game The game data.
+ */
+void clear_enemies(game_data &game);
 
 #endif // ENEMY_H
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef ENTITY_CONTAINER_H
+#define ENTITY_CONTAINER_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * Removal helpers shared by the game's entity vectors.
+ *
+ * Entities are removed by moving the last element into the freed slot, so a
+ * removal costs one move however long the vector is, and the order of the
+ * remaining entities is not preserved. Code that removes while iterating
+ * walks the vector from the end, so the element moved into a slot has always
+ * been visited already. Entities own their sprites, so the move and the
+ * pop_back return the removed entity's sprite to its pool.
+ */
+
+/**
+ * Remove an element in constant time by moving the last element into its slot.
+ *
+ * @param items The vector to remove from.
+ * @param index The index of the element to remove.
+ */
+template <typename T>
+void swap_remove(std::vector<T> &items, size_t index) {
+    if (index + 1 != items.size()) {
+        items[index] = std::move(items.back());
+    }
+    items.pop_back();
+}
+
+#endif // ENTITY_CONTAINER_H
@@ -1,111 +1,100 @@
-#include "splashkit.h"
+#include "platform.h"
+#include "atlas.h"
 #include "game_data.h"
 #include "explosion.h"
+#include <algorithm>
+#include <cmath>
 
 /**
- * Create a new explosion at a given position.
- * It takes the game data, x-coordinate, and y-coordinate as input.
- * The function initialises the explosion data by creating an explosion sprite and bitmap,
- * setting the position, timing, frame data, and adds the explosion to the game data.
+ * Create an empty explosion ring and work out the cells of the "explode" strip.
  *
- * @param game The game data.
- * @param x The x-coordinate of the explosion.
- * @param y The y-coordinate of the explosion.
+ * @param capacity The most explosions alive at once.
+ * @return The new ring.
  */
-void add_explosion(game_data &game, float x, float y) {
-    // Initialise explosion data
-    explosion_data explosion;
-
-    // Create explosion sprite and bitmap
-    explosion.explosion_sprite = create_sprite("explode");
-    explosion.explosion_bitmap = bitmap_named("explode");
+explosion_ring_data new_explosion_ring(int capacity) {
+    explosion_ring_data result;
+    result.slots.resize(capacity);
+    result.head = 0;
+    result.count = 0;
+    result.sheet = bitmap_named("explode");
+    result.now = 0;     // The game clock starts at zero
 
-    // Set the position of the explosion
-    sprite_set_position(explosion.explosion_sprite, point_2d { x, y });
+    // Cells are as tall as the sheet and laid out left to right
+    double cell_height = bitmap_height(result.sheet);
+    int cell_count = std::max(1, static_cast<int>(lround(bitmap_width(result.sheet) / cell_height)));
+    double cell_width = bitmap_width(result.sheet) / static_cast<double>(cell_count);
 
-    // Initialise explosion timing and frame data
-    explosion.start_time = current_ticks();
-    explosion.should_remove = false;
-    explosion.frame_index = 0;
-    explosion.frame_duration = 300; // Set the frame duration (in milliseconds)
+    for (int i = 0; i < cell_count; i++) {
+        result.cells.push_back({ cell_width * i, 0, cell_width, cell_height });
+    }
+    result.lifetime = cell_count * EXPLOSION_CELL_DURATION;
 
-    // Add the explosion to the game data
-    game.explosions.push_back(explosion);
+    return result;
 }
 
 /**
- * Update the frame index and removal status of an explosion.
- * It takes the explosion data as input.
- * The function calculates the current time and updates the frame index based on the elapsed time.
- * If all frames have been shown, the explosion is marked for removal.
+ * Add an explosion at a given position, replacing the oldest one if the ring is full.
  *
- * @param explosion The explosion data.
+ * @param game The game data.
+ * @param x The x-coordinate of the explosion.
+ * @param y The y-coordinate of the explosion.
  */
-void update_explosion(explosion_data &explosion) {
-    // Get the current time
-    double current_time = current_ticks();
-
-    // Define the number of frames in the explosion animation
-    const int NUMBER_OF_FRAMES = 300;
-
-    // If enough time has passed, advance to the next frame
-    if (current_time - explosion.start_time >= explosion.frame_duration) {
-        explosion.start_time = current_time;
-        explosion.frame_index++;
+void add_explosion(game_data &game, float x, float y) {
+    explosion_ring_data &explosions = game.explosions;
+    int capacity = explosions.slots.size();
 
-        // If all frames have been shown, mark the explosion for removal
-        if (explosion.frame_index >= NUMBER_OF_FRAMES) { 
-            explosion.should_remove = true;
-        }
+    if (explosions.count == capacity) {
+        explosions.head = (explosions.head + 1) % capacity;
+        explosions.count--;
     }
+
+    int tail = (explosions.head + explosions.count) % capacity;
+    explosions.slots[tail] = { point_at(x, y), game_clock_ticks(game.clock) };
+    explosions.count++;
 }
 
 /**
- * Update all explosions in the game.
- * It takes the game data as input.
- * The function iterates through all explosions in reverse order, updating each explosion.
- * If an explosion is marked for removal, it frees the sprite memory and removes it from the game data.
+ * Read the clock once for every explosion and pop the ones that have shown
+ * their last cell from the head of the ring.
  *
  * @param game The game data.
  */
 void update_explosions(game_data &game) {
-    // Iterate through all explosions in reverse order
-    for (int i = game.explosions.size() - 1; i >= 0; i--) {
-        // Update the current explosion
-        update_explosion(game.explosions[i]);
+    explosion_ring_data &explosions = game.explosions;
+    int capacity = explosions.slots.size();
+    explosions.now = game_clock_ticks(game.clock);
 
-        // If the explosion is marked for removal, remove it
-        if (game.explosions[i].should_remove) {
-            // Free the sprite memory and erase it from the game data
-            free_sprite(game.explosions[i].explosion_sprite);
-            game.explosions.erase(game.explosions.begin() + i);
-        }
+    while (explosions.count > 0 && explosions.now - explosions.slots[explosions.head].start_time >= explosions.lifetime) {
+        explosions.head = (explosions.head + 1) % capacity;
+        explosions.count--;
     }
 }
 
 /**
- * Draw a single frame of the explosion.
- * It takes the explosion data as input.
- * The function gets the current position of the explosion,
- * defines the frame dimensions, selects the part of the bitmap to draw, and draws the bitmap at the explosion position.
+ * Queue the current cell of the visible explosions, picked from the time since each started.
  *
- * @param explosion The explosion data.
+ * @param explosions The explosion ring.
+ * @param visible The offsets from the head of the ring of the explosions to draw.
  */
-void draw_explosion(const explosion_data &explosion) {
-    // Get the current position of the explosion
-    point_2d explosion_position = sprite_position(explosion.explosion_sprite);
-    
-    // Define the frame dimensions
-    double frame_width = bitmap_width(explosion.explosion_bitmap);
-    double frame_height = bitmap_height(explosion.explosion_bitmap);
+void draw_explosions(const explosion_ring_data &explosions, const vector<int> &visible) {
+    int capacity = explosions.slots.size();
 
-    // Define the part of the bitmap to draw
-    double x = frame_width * explosion.frame_index;
-    double y = 0;
+    for (int offset : visible) {
+        const explosion_data &explosion = explosions.slots[(explosions.head + offset) % capacity];
 
-    // Create drawing options for the part of the bitmap
-    drawing_options part_bmp_opts = option_part_bmp(x, y, frame_width, frame_height);
+        // An explosion added since the last update has not started yet
+        unsigned int elapsed = explosions.now >= explosion.start_time ? explosions.now - explosion.start_time : 0;
+        int cell_index = std::min<unsigned int>(elapsed / EXPLOSION_CELL_DURATION, explosions.cells.size() - 1);
+        queue_image_draw(explosions.sheet, explosions.cells[cell_index], explosion.position.x, explosion.position.y, 0, LAYER_EXPLOSIONS);
+    }
+}
 
-    // Draw the bitmap at the explosion position
-    draw_bitmap(explosion.explosion_bitmap, explosion_position.x, explosion_position.y, part_bmp_opts);
+/**
+ * Returns the number of live explosions.
+ *
+ * @param explosions The explosion ring.
+ * @return The number of explosions.
+ */
+int explosion_count(const explosion_ring_data &explosions) {
+    return explosions.count;
 }
@@ -1,30 +1,59 @@
 #ifndef EXPLOSION_H
 #define EXPLOSION_H
 
-#include "splashkit.h"
-#include "game_data.h"
-#include "explosion.h"
+#include "platform.h"
+#include <vector>
 
+struct game_data;
+
+// Most explosions alive at once; adding one more replaces the oldest
+const int EXPLOSION_CAPACITY = 256;
+
+// Time each cell of the explosion sprite sheet is shown, in milliseconds
+const unsigned int EXPLOSION_CELL_DURATION = 300;
 
 /**
- * Structure representing explosion data.
- * It holds information about the explosion's sprite, bitmap, start time, removal flag,
- * current frame index, and frame duration.
+ * Structure representing one explosion.
+ * Explosions share the sprite sheet and clock of their ring, so each one
+ * only needs its position and the time it started.
  */
 struct explosion_data {
-    sprite explosion_sprite;     // Sprite object representing the explosion
-    bitmap explosion_bitmap;     // Bitmap associated with the explosion
-    double start_time;           // Time when the explosion started
-    bool should_remove;          // Flag indicating if the explosion should be removed
-    int frame_index;             // Index of the current frame of the explosion animation
-    double frame_duration;       // Duration of each frame in the explosion animation
+    point_2d position;          // Top left of the explosion
+    unsigned int start_time;    // Time when the explosion started
+};
+
+/**
+ * Fixed-capacity ring buffer holding every live explosion.
+ *
+ * Every explosion lives for the same time, exactly until the last cell of the
+ * "explode" strip has been shown, and they are added in time order, so the
+ * oldest explosion is always at the head and expiry only pops from the head.
+ * The cell rectangles of the strip are worked out once when the ring is
+ * created, and the clock is read once per update and shared by every
+ * explosion for both update and draw.
+ */
+struct explosion_ring_data {
+    vector<explosion_data> slots;   // Ring storage, sized to the capacity
+    int head;                       // Index of the oldest explosion
+    int count;                      // Number of live explosions
+    bitmap sheet;                   // The "explode" sprite sheet
+    vector<rectangle> cells;        // Cell rectangles of the sheet, in playing order
+    unsigned int lifetime;          // Time from start until the last cell ends
+    unsigned int now;               // Clock read by the last update_explosions
 };
 
+/**
+ * Create an empty explosion ring and work out the cells of the "explode"
+ * strip. The strip is a row of square-ish cells as tall as the bitmap.
+ *
+ * @param capacity The most explosions alive at once.
+ * @return The new ring.
+ */
+explosion_ring_data new_explosion_ring(int capacity);
+
 /**
  * Add an explosion at the specified position.
- * It takes the game data, x-coordinate, and y-coordinate as input.
- * The function creates a new explosion by initializing the explosion data
- * with the provided position and adds it to the game data's explosions vector.
+ * If the ring is full the oldest explosion is replaced.
  *
  * @param game The game data.
  * @param x The x-coordinate of the explosion.
@@ -33,33 +62,27 @@ struct explosion_data {
 void add_explosion(game_data &game, float x, float y);
 
 /**
- * Update an explosion's animation.
- * It takes the explosion data as input.
- * The function updates the explosion's frame index and checks if all frames have been shown,
- * marking the explosion for removal if necessary.
+ * Advance the shared explosion clock and remove the explosions that have
+ * shown their last cell.
  *
- * @param explosion The explosion data.
+ * @param game The game data.
  */
-void update_explosion(explosion_data &explosion);
+void update_explosions(game_data &game);
 
 /**
- * Update all explosions in the game.
- * It takes the game data as input.
- * The function iterates through all explosions in the game's explosions vector,
- * updating each explosion's animation and removing any explosions marked for removal.
+ * Draw the current cell of the visible explosions.
  *
- * @param game The game data.
+ * @param explosions The explosion ring.
+ * @param visible The offsets from the head of the ring of the explosions to draw, from cull_to_view.
  */
-void update_explosions(game_data &game);
+void draw_explosions(const explosion_ring_data &explosions, const vector<int> &visible);
 
 /**
- * Draw an explosion's current frame.
- * It takes the explosion data as input.
- * The function draws the current frame of the explosion's bitmap at the sprite's position.
+ * Returns the number of live explosions.
  *
- * @param explosion The explosion data.
+ * @param explosions The explosion ring.
+ * @return The number of explosions.
  */
-void draw_explosion(const explosion_data &explosion);
-
+int explosion_count(const explosion_ring_data &explosions);
 
 #endif
@@ -0,0 +1,112 @@
+#include "frame_limiter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+/**
+ * State of the frame limiter. Deadlines are read from the steady clock, so
+ * pacing follows wall time even in the headless build.
+ */
+struct frame_limiter_data {
+    double frame_ms = 0.0;              // Target length of a frame
+    bool uncapped = true;               // True to skip waiting altogether
+    double next_deadline_ms = 0.0;      // Steady clock time the current frame should end at
+    long frame_count = 0;               // Frames paced since the limiter started
+    long missed_count = 0;              // Frames that finished after their deadline
+    double worst_overrun_ms = 0.0;      // Latest a frame finished after its deadline
+};
+
+static frame_limiter_data limiter;
+
+/**
+ * Returns the steady clock in milliseconds.
+ *
+ * @return The current time; only differences are meaningful.
+ */
+static double steady_now_ms() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Starts pacing frames to a target rate, or not at all when uncapped.
+ *
+ * @param fps The target frames per second.
+ * @param uncapped True to run frames as fast as possible.
+ */
+void start_frame_limiter(double fps, bool uncapped) {
+    limiter = frame_limiter_data();
+    limiter.frame_ms = 1000.0 / fps;
+    limiter.uncapped = uncapped;
+    limiter.next_deadline_ms = steady_now_ms() + limiter.frame_ms;
+}
+
+/**
+ * Waits until the current frame's deadline, sleeping first and spinning for the last stretch.
+ */
+void wait_for_next_frame() {
+    limiter.frame_count++;
+    if (limiter.uncapped) {
+        return;
+    }
+
+    double now = steady_now_ms();
+    if (now > limiter.next_deadline_ms) {
+        // Missed: count it and start a fresh deadline rather than rushing the following frames to catch up
+        limiter.missed_count++;
+        limiter.worst_overrun_ms = std::max(limiter.worst_overrun_ms, now - limiter.next_deadline_ms);
+        limiter.next_deadline_ms = now + limiter.frame_ms;
+        return;
+    }
+
+    double sleep_ms = limiter.next_deadline_ms - now - FRAME_LIMITER_SPIN_MS;
+    if (sleep_ms > 0.0) {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(sleep_ms));
+    }
+    while (steady_now_ms() < limiter.next_deadline_ms) {
+        std::this_thread::yield();
+    }
+
+    limiter.next_deadline_ms += limiter.frame_ms;
+}
+
+/**
+ * Returns the number of frames paced since the limiter started.
+ *
+ * @return The frame count.
+ */
+long frame_limiter_frame_count() {
+    return limiter.frame_count;
+}
+
+/**
+ * Returns the number of frames that finished after their deadline.
+ *
+ * @return The missed deadline count.
+ */
+long frame_limiter_missed_count() {
+    return limiter.missed_count;
+}
+
+/**
+ * Returns the latest a frame has finished after its deadline.
+ *
+ * @return The worst overrun in milliseconds.
+ */
+double frame_limiter_worst_overrun_ms() {
+    return limiter.worst_overrun_ms;
+}
+
+/**
+ * Prints the frame count, missed deadlines and worst overrun to standard output.
+ */
+void print_frame_limiter_report() {
+    if (limiter.uncapped) {
+        printf("frame limiter: uncapped, %ld frames\n", limiter.frame_count);
+        return;
+    }
+
+    double missed_pct = limiter.frame_count > 0 ? 100.0 * limiter.missed_count / limiter.frame_count : 0.0;
+    printf("frame limiter: %.0f fps target, %ld frames, %ld missed deadlines (%.2f%%), worst overrun %.2f ms\n",
+           1000.0 / limiter.frame_ms, limiter.frame_count, limiter.missed_count, missed_pct, limiter.worst_overrun_ms);
+}
@@ -0,0 +1,52 @@
+#ifndef FRAME_LIMITER_H
+#define FRAME_LIMITER_H
+
+// Frames per second the limiter paces to unless uncapped
+const double TARGET_FPS = 60.0;
+
+// The limiter sleeps until this many milliseconds before a deadline and spins for the rest, since OS sleeps can overshoot by a millisecond or more
+const double FRAME_LIMITER_SPIN_MS = 2.0;
+
+/**
+ * Starts pacing frames to a target rate, or not at all when uncapped.
+ *
+ * @param fps The target frames per second.
+ * @param uncapped True to run frames as fast as possible, e.g. for benchmarking.
+ */
+void start_frame_limiter(double fps, bool uncapped);
+
+/**
+ * Waits until the current frame's deadline, sleeping first and spinning for
+ * the last FRAME_LIMITER_SPIN_MS. A frame that finishes after its deadline
+ * counts as missed, and the next deadline is set from now instead of being
+ * chased. Returns at once when uncapped. Call once at the end of every frame.
+ */
+void wait_for_next_frame();
+
+/**
+ * Returns the number of frames paced since the limiter started.
+ *
+ * @return The frame count.
+ */
+long frame_limiter_frame_count();
+
+/**
+ * Returns the number of frames that finished after their deadline.
+ *
+ * @return The missed deadline count; always 0 when uncapped.
+ */
+long frame_limiter_missed_count();
+
+/**
+ * Returns the latest a frame has finished after its deadline.
+ *
+ * @return The worst overrun in milliseconds.
+ */
+double frame_limiter_worst_overrun_ms();
+
+/**
+ * Prints the frame count, missed deadlines and worst overrun to standard output.
+ */
+void print_frame_limiter_report();
+
+#endif // FRAME_LIMITER_H
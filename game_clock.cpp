@@ -0,0 +1,110 @@
+#include "platform.h"
+#include "game_clock.h"
+#include <algorithm>
+#include <chrono>
+
+/**
+ * Returns the current reading of the monotonic clock source in milliseconds.
+ * In the headless build this is the simulated clock.
+ *
+ * @return The reading.
+ */
+double clock_source_ms() {
+#ifdef LOST_IN_SPACE_HEADLESS
+    return headless_time_ms();
+#else
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * Creates a clock whose real and simulation time start at zero.
+ *
+ * @return The new clock.
+ */
+game_clock_data new_game_clock() {
+    return { clock_source_ms(), 0.0, 0.0, 0.0, 1.0, false };
+}
+
+/**
+ * Read the clock source, advance real time and fill the step accumulator.
+ *
+ * @param clock The clock to advance.
+ */
+void tick_game_clock(game_clock_data &clock) {
+    double now = clock_source_ms();
+    double frame_ms = std::min(now - clock.last_source_ms, GAME_CLOCK_MAX_DT * 1000.0);
+    clock.last_source_ms = now;
+    clock.real_ms += frame_ms;
+
+    if (!clock.paused) {
+        clock.accumulator_ms = std::min(clock.accumulator_ms + frame_ms * clock.time_scale, GAME_CLOCK_MAX_DT * 1000.0);
+    }
+}
+
+/**
+ * Throw away the time waiting in the step accumulator.
+ *
+ * @param clock The clock to reset.
+ */
+void discard_game_clock_backlog(game_clock_data &clock) {
+    clock.last_source_ms = clock_source_ms();
+    clock.accumulator_ms = 0.0;
+}
+
+/**
+ * Take one fixed simulation step from the accumulator if a whole step is available.
+ *
+ * @param clock The clock to step.
+ * @return True if a step was taken.
+ */
+bool game_clock_step(game_clock_data &clock) {
+    const double step_ms = GAME_CLOCK_STEP * 1000.0;
+    if (clock.accumulator_ms + GAME_CLOCK_STEP_SNAP_MS < step_ms) {
+        return false;
+    }
+
+    clock.accumulator_ms = std::max(clock.accumulator_ms - step_ms, 0.0);
+    clock.sim_ms += step_ms;
+    return true;
+}
+
+/**
+ * Returns how far the current frame is between the last two simulation steps.
+ *
+ * @param clock The clock to read.
+ * @return The interpolation factor, from 0 to 1.
+ */
+double game_clock_alpha(const game_clock_data &clock) {
+    return std::min(clock.accumulator_ms / (GAME_CLOCK_STEP * 1000.0), 1.0);
+}
+
+/**
+ * Returns the simulation time in whole milliseconds.
+ *
+ * @param clock The clock to read.
+ * @return The simulation time.
+ */
+unsigned int game_clock_ticks(const game_clock_data &clock) {
+    return static_cast<unsigned int>(clock.sim_ms);
+}
+
+/**
+ * Pause or resume simulation time.
+ *
+ * @param clock The clock to change.
+ * @param paused True to stop simulation time.
+ */
+void set_game_clock_paused(game_clock_data &clock, bool paused) {
+    clock.paused = paused;
+}
+
+/**
+ * Set how fast simulation time runs relative to real time.
+ *
+ * @param clock The clock to change.
+ * @param scale The new time scale.
+ */
+void set_game_clock_scale(game_clock_data &clock, double scale) {
+    clock.time_scale = std::max(scale, 0.0);
+}
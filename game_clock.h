@@ -0,0 +1,111 @@
+#ifndef GAME_CLOCK_H
+#define GAME_CLOCK_H
+
+// Simulation steps per second. Movement is tuned in units per step, so changing this changes the game speed
+const double SIMULATION_HZ = 60.0;
+
+// Length of one simulation step in seconds
+const double GAME_CLOCK_STEP = 1.0 / SIMULATION_HZ;
+
+// Longest frame step the clock reports, and the most time the step accumulator holds, in seconds, so a stall (a breakpoint, a window drag) does not teleport the simulation
+const double GAME_CLOCK_MAX_DT = 0.25;
+
+// Leftover time this close to a whole step, in milliseconds, counts as a whole step, so rounding in the clock source does not skip a step one frame and run two the next
+const double GAME_CLOCK_STEP_SNAP_MS = 0.001;
+
+/**
+ * The single time source of a game.
+ *
+ * Reads a monotonic high resolution clock once per frame and adds the
+ * elapsed time to an accumulator, which game_clock_step drains in fixed
+ * GAME_CLOCK_STEP steps. Simulation time only advances by whole steps, stops
+ * while paused and runs at time_scale, so every timer and spawner driven
+ * from it pauses and slows down together. Real time keeps running and is
+ * used for things that should not pause, such as HUD refreshes and the
+ * radar pulse.
+ */
+struct game_clock_data {
+    double last_source_ms;  // Reading of the clock source at the last tick
+    double real_ms;         // Milliseconds since the clock was created, never paused or scaled
+    double sim_ms;          // Milliseconds of simulation time
+    double accumulator_ms;  // Scaled time not yet consumed by a simulation step
+    double time_scale;      // Speed of simulation time relative to real time
+    bool paused;            // True while simulation time is stopped
+};
+
+/**
+ * Returns the current reading of the monotonic clock source in milliseconds.
+ * In the headless build this is the simulated clock.
+ *
+ * @return The reading; only differences between readings are meaningful.
+ */
+double clock_source_ms();
+
+/**
+ * Creates a clock whose real and simulation time start at zero.
+ *
+ * @return The new clock.
+ */
+game_clock_data new_game_clock();
+
+/**
+ * Read the clock source, advance real time and add the scaled frame time to
+ * the step accumulator. Call once per frame.
+ *
+ * @param clock The clock to advance.
+ */
+void tick_game_clock(game_clock_data &clock);
+
+/**
+ * Throw away the time waiting in the step accumulator, so the next frame
+ * starts from a clean step. Call when the simulation starts running after
+ * time has passed outside it, such as on leaving the start menu.
+ *
+ * @param clock The clock to reset.
+ */
+void discard_game_clock_backlog(game_clock_data &clock);
+
+/**
+ * Take one fixed simulation step from the accumulator if a whole step is
+ * available, advancing simulation time by GAME_CLOCK_STEP. Call in a loop,
+ * running one update per true result.
+ *
+ * @param clock The clock to step.
+ * @return True if a step was taken.
+ */
+bool game_clock_step(game_clock_data &clock);
+
+/**
+ * Returns how far the current frame is between the last two simulation
+ * steps, for interpolating what is drawn.
+ *
+ * @param clock The clock to read.
+ * @return 0 at the previous step up to 1 at the latest one.
+ */
+double game_clock_alpha(const game_clock_data &clock);
+
+/**
+ * Returns the simulation time in whole milliseconds, for comparison against stored ticks.
+ *
+ * @param clock The clock to read.
+ * @return The simulation time.
+ */
+unsigned int game_clock_ticks(const game_clock_data &clock);
+
+/**
+ * Pause or resume simulation time.
+ *
+ * @param clock The clock to change.
+ * @param paused True to stop simulation time, false to resume it.
+ */
+void set_game_clock_paused(game_clock_data &clock, bool paused);
+
+/**
+ * Set how fast simulation time runs relative to real time.
+ *
+ * @param clock The clock to change.
+ * @param scale The new time scale; negative values are treated as zero.
+ */
+void set_game_clock_scale(game_clock_data &clock, double scale);
+
+#endif // GAME_CLOCK_H
@@ -1,4 +1,4 @@
-#include "splashkit.h"
+#include "platform.h"
 #include "enemy.h"
 #include "game_data.h"
 #include "player.h"
@@ -8,24 +8,85 @@
 #include "shooting.h"
 #include "kill_streaks.h"
 #include "explosion.h"
+#include "sprites.h"
+#include "atlas.h"
+
+// Free sprites created up front for each bitmap by prewarm_sprite_pools
+const int PREWARM_POWER_UP_SPRITES = 10;    // A whole spawn burst of one kind
+const int PREWARM_ENEMY_SPRITES = 8;
+const int PREWARM_PLANET_SPRITES = 4;
 
 /**
 * Creates a new game by initialising a new game_data object, creating a new player with new_player(),
 * and assigning the player to the player field of the game_data object.
+*  @param seed The seed for the game's random number stream.
 *  @return The newly created game_data object.
 */
-game_data new_game() {
+game_data new_game(uint64_t seed) {
     game_data game;
+    game.rng = new_rng(seed);
+    game.state = game_state::START_MENU;
+    game.intro_music_started = false;
     game.player = new_player();
     spawn_all_enemies(game);
+    generate_planet_field(game);
     game.map_width = MAX_X - MIN_X;
     game.map_height = MAX_Y - MIN_Y;
+    game.projectiles = new_projectile_pool(PROJECTILE_POOL_CAPACITY);
+    game.explosions = new_explosion_ring(EXPLOSION_CAPACITY);
+    game.enemy_grid = new_spatial_grid(MIN_X, MIN_Y, MAX_X, MAX_Y, SPATIAL_GRID_CELL_SIZE);
     game.is_kill_streak_active = false;
-    game.game_timer = create_timer("game_timer"); 
-    start_timer(game.game_timer);
+    game.clock = new_game_clock();
+    game.previous_camera = point_at(camera_x(), camera_y());
     return game;
 }
 
+/**
+ * Fill the sprite pools with the sprites that spawn in bursts: power-ups,
+ * enemies and planets.
+ */
+void prewarm_sprite_pools() {
+    for (power_up_kind kind : { SHIELD, FUEL, ROCKET, TIME }) {
+        prewarm_sprite_pool(power_up_bitmap(kind), PREWARM_POWER_UP_SPRITES);
+    }
+
+    for (enemy_kind kind : { enemy_kind::ENEMY_TYPE1, enemy_kind::ENEMY_TYPE2, enemy_kind::ENEMY_TYPE3, enemy_kind::ENEMY_BOSS }) {
+        prewarm_sprite_pool(enemy_bitmap(kind), PREWARM_ENEMY_SPRITES);
+    }
+
+    for (int kind = MERCURY; kind <= PLUTO; kind++) {
+        prewarm_sprite_pool(planet_bitmap(static_cast<planet_kind>(kind)), PREWARM_PLANET_SPRITES);
+    }
+}
+
+/**
+ * Pack the images drawn every frame into the texture atlas.
+ */
+void build_game_atlas() {
+    std::vector<bitmap> images;
+
+    for (ship_kind kind : { AQUARII, GLIESE, PEGASI }) {
+        images.push_back(ship_bitmap(kind));
+    }
+    for (enemy_kind kind : { enemy_kind::ENEMY_TYPE1, enemy_kind::ENEMY_TYPE2, enemy_kind::ENEMY_TYPE3, enemy_kind::ENEMY_BOSS }) {
+        images.push_back(enemy_bitmap(kind));
+    }
+    for (int kind = MERCURY; kind <= PLUTO; kind++) {
+        images.push_back(planet_bitmap(static_cast<planet_kind>(kind)));
+    }
+    for (power_up_kind kind : { SHIELD, FUEL, ROCKET, TIME }) {
+        images.push_back(power_up_bitmap(kind));
+    }
+    images.push_back(bitmap_named("explode"));
+
+    // Images drawn by draw_hud
+    for (const char *name : { "kill_count", "HUD_bullet", "HUD_time", "empty", "full", "purple_bar" }) {
+        images.push_back(bitmap_named(name));
+    }
+
+    build_atlas(images);
+}
+
 // This function handles the game overs
 void game_over(game_data &game) {
     game.state = game_state::GAME_OVER;  // Set game state to GAME_OVER
@@ -1,17 +1,22 @@
 #ifndef GAME_DATA_H
 #define GAME_DATA_H
 
-#include "splashkit.h"
+#include "platform.h"
 #include "planets.h"
 #include "shooting.h"
 #include "enemy.h" 
 #include "power_up.h"
+#include "explosion.h"
+#include "game_clock.h"
+#include "rng.h"
+#include "handle_table.h"
+#include "spatial_grid.h"
+#include <cstdint>
 #include <map>
 
 // Forward declaration of different game data structures
 struct enemy_data;      // Data related to enemies in the game
 struct player_data;     // Data related to the player in the game
-struct explosion_data;  // Data related to explosions in the game
 struct power_up_data;   // Data related to power-ups in the game
 struct projectile_data; // Data related to projectiles in the game
 
@@ -28,31 +33,51 @@ enum game_state {
 /**
  * Creates a new game
  *
+ * @param seed The seed for the game's random number stream.
  * @return The newly created game.
  */
-game_data new_game();
+game_data new_game(uint64_t seed);
+
+/**
+ * Fill the sprite pools with the sprites that spawn in bursts, so that
+ * spawning takes a pooled sprite instead of creating one. Called once the
+ * resources are loaded.
+ */
+void prewarm_sprite_pools();
+
+/**
+ * Pack the ship, enemy, planet, power-up, explosion and HUD images into the
+ * texture atlas. Called once the resources are loaded.
+ */
+void build_game_atlas();
 
 // Struct for holding all data related to a game instance
 struct game_data {
     player_data player;                     // The player data
     vector<planet_data> planets;            // Vector to hold all the planets in the game
     vector<enemy_data> enemies;             // Vector to hold all the enemies in the game
-    vector<projectile_data> projectiles;    // Vector to hold all the projectiles in the game
+    handle_table_data enemy_handles;        // Handles of the enemies, kept in step by insert_enemy and flush_destroyed_enemies
+    projectile_pool_data projectiles;       // Pool holding all the projectiles in the game
     vector<power_up_data> power_ups;        // Vector to hold all the power-ups in the game
-    vector<explosion_data> explosions;      // Vector to hold all the explosions in the game
+    explosion_ring_data explosions;         // Ring buffer holding all the explosions in the game
+    spatial_grid_data enemy_grid;           // Broad phase grid of enemy collision circles, rebuilt each tick
     std::map<enemy_kind, float> original_damage_values;  // Map to hold the original damage values of each enemy kind
     int map_width;                          // Width of the game map
     int map_height;                         // Height of the game map
     bool is_kill_streak_active;             // Flag to check if a kill streak is currently active
     double last_kill_streak_tick;           // Time of the last kill streak tick
-    timer game_timer;                       // Timer for the game
+    game_clock_data clock;                  // Time source for every timer, spawner and animation in the game
+    point_2d previous_camera;               // Camera position before the last simulation step, for interpolation
     game_state state;                       // Current state of the game
     bool intro_music_started;               // Flag to check if the intro music has started
+    rng_data rng;                           // Random number stream used by every spawn and AI decision
+    bool show_performance_overlay = false;  // Flag to show the performance panel next to the HUD
     unsigned int last_enemy_spawn_tick = 0;
     unsigned int enemy_spawn_interval = 3000; // 5 seconds in milliseconds
     unsigned int last_power_up_spawn_tick = 0;
     unsigned int power_up_spawn_interval = 10000; // 10 seconds in milliseconds
     unsigned int last_second_tick = 0;
+    unsigned int last_wander_tick = 0;        // Time an enemy last picked a new patrol direction
 };
 
 /**
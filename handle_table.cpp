@@ -0,0 +1,108 @@
+#include "handle_table.h"
+
+/**
+ * Give a handle to an entity just appended to the container, reusing a
+ * released slot when there is one.
+ *
+ * @param table The container's table.
+ * @return The entity's handle.
+ */
+entity_handle handle_table_add(handle_table_data &table) {
+    uint32_t slot;
+    if (!table.free_slots.empty()) {
+        slot = table.free_slots.back();
+        table.free_slots.pop_back();
+    } else {
+        slot = table.generations.size();
+        table.generations.push_back(0);
+        table.slot_index.push_back(-1);
+        table.slot_pending.push_back(false);
+    }
+
+    table.slot_index[slot] = table.index_slot.size();
+    table.index_slot.push_back(slot);
+    return { slot, table.generations[slot] };
+}
+
+/**
+ * Release the handle of the entity at an index. The slot of the entity that
+ * was moved from the end now points at the index, and the released slot's
+ * generation is bumped so its old handles stop resolving.
+ *
+ * @param table The container's table.
+ * @param index The index that was removed.
+ */
+void handle_table_remove_index(handle_table_data &table, int index) {
+    uint32_t slot = table.index_slot[index];
+    uint32_t moved_slot = table.index_slot.back();
+
+    table.index_slot[index] = moved_slot;
+    table.slot_index[moved_slot] = index;
+    table.index_slot.pop_back();
+
+    table.generations[slot]++;
+    table.slot_index[slot] = -1;
+    table.slot_pending[slot] = false;
+    table.free_slots.push_back(slot);
+}
+
+/**
+ * Returns the current index of a handle's entity.
+ *
+ * @param table The container's table.
+ * @param handle The handle to look up.
+ * @return The entity's index, or -1 if it has been destroyed.
+ */
+int handle_index(const handle_table_data &table, entity_handle handle) {
+    if (handle.slot >= table.generations.size() || table.generations[handle.slot] != handle.generation) {
+        return -1;
+    }
+    return table.slot_index[handle.slot];
+}
+
+/**
+ * Returns the handle of the entity at an index.
+ *
+ * @param table The container's table.
+ * @param index The entity's index.
+ * @return The entity's handle.
+ */
+entity_handle handle_at(const handle_table_data &table, int index) {
+    uint32_t slot = table.index_slot[index];
+    return { slot, table.generations[slot] };
+}
+
+/**
+ * Queue an entity to be destroyed by the next flush_destroyed_entities.
+ *
+ * @param table The container's table.
+ * @param handle The entity to destroy.
+ */
+void handle_table_destroy_later(handle_table_data &table, entity_handle handle) {
+    if (handle_index(table, handle) < 0 || table.slot_pending[handle.slot]) {
+        return;
+    }
+    table.slot_pending[handle.slot] = true;
+    table.pending.push_back(handle);
+}
+
+/**
+ * Returns whether the entity at an index is queued for destruction.
+ *
+ * @param table The container's table.
+ * @param index The entity's index.
+ * @return True if the entity is queued for destruction, false otherwise.
+ */
+bool index_destroy_pending(const handle_table_data &table, int index) {
+    return table.slot_pending[table.index_slot[index]];
+}
+
+/**
+ * Returns the number of entities in the container.
+ *
+ * @param table The container's table.
+ * @return The number of entities.
+ */
+int handle_table_size(const handle_table_data &table) {
+    return table.index_slot.size();
+}
@@ -0,0 +1,125 @@
+#ifndef HANDLE_TABLE_H
+#define HANDLE_TABLE_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Stable reference to an entity kept in a densely packed container.
+ *
+ * The slot identifies a table entry that follows the entity wherever it is
+ * moved in the container; the generation is bumped every time the slot is
+ * released, so a handle to a destroyed entity never resolves, even after the
+ * slot is reused.
+ */
+struct entity_handle {
+    uint32_t slot;          // Table entry the entity was given
+    uint32_t generation;    // Generation of the slot when the handle was made
+};
+
+// A handle that never resolves
+const entity_handle NULL_HANDLE = { UINT32_MAX, 0 };
+
+/**
+ * Maps handles to the current index of their entity in a dense container
+ * (a vector or a set of parallel arrays) that removes with swap-and-pop.
+ *
+ * The owner of the container keeps the table in step: handle_table_add when
+ * an entity is appended, and handle_table_remove_index after the last entity
+ * has been moved into a removed entity's index. Entities can also be queued
+ * with handle_table_destroy_later and removed together by
+ * flush_destroyed_entities at the end of the frame, so indices and references
+ * stay valid while the frame's systems run.
+ */
+struct handle_table_data {
+    std::vector<uint32_t> generations;      // Current generation of each slot
+    std::vector<int> slot_index;            // Index of each slot's entity, or -1 if the slot is free
+    std::vector<bool> slot_pending;         // Whether each slot's entity is queued for destruction
+    std::vector<uint32_t> index_slot;       // Slot of the entity at each index
+    std::vector<uint32_t> free_slots;       // Released slots ready for reuse
+    std::vector<entity_handle> pending;     // Entities queued for destruction, in queue order
+};
+
+/**
+ * Give a handle to an entity just appended to the container.
+ *
+ * @param table The container's table.
+ * @return The entity's handle.
+ */
+entity_handle handle_table_add(handle_table_data &table);
+
+/**
+ * Release the handle of the entity at an index, after the container has moved
+ * its last entity into that index and dropped its last element.
+ *
+ * @param table The container's table.
+ * @param index The index that was removed.
+ */
+void handle_table_remove_index(handle_table_data &table, int index);
+
+/**
+ * Returns the current index of a handle's entity.
+ *
+ * @param table The container's table.
+ * @param handle The handle to look up.
+ * @return The entity's index, or -1 if it has been destroyed.
+ */
+int handle_index(const handle_table_data &table, entity_handle handle);
+
+/**
+ * Returns the handle of the entity at an index.
+ *
+ * @param table The container's table.
+ * @param index The entity's index.
+ * @return The entity's handle.
+ */
+entity_handle handle_at(const handle_table_data &table, int index);
+
+/**
+ * Queue an entity to be destroyed by the next flush_destroyed_entities.
+ * Queuing it again, or queuing a stale handle, does nothing.
+ *
+ * @param table The container's table.
+ * @param handle The entity to destroy.
+ */
+void handle_table_destroy_later(handle_table_data &table, entity_handle handle);
+
+/**
+ * Returns whether the entity at an index is queued for destruction.
+ * Systems skip such entities for the rest of the frame.
+ *
+ * @param table The container's table.
+ * @param index The entity's index.
+ * @return True if the entity is queued for destruction, false otherwise.
+ */
+bool index_destroy_pending(const handle_table_data &table, int index);
+
+/**
+ * Returns the number of entities in the container.
+ *
+ * @param table The container's table.
+ * @return The number of entities.
+ */
+int handle_table_size(const handle_table_data &table);
+
+/**
+ * Remove every entity queued for destruction.
+ *
+ * @param table The container's table.
+ * @param remove_at Called with the index of each entity to remove; it must
+ *                  release the entity and move the container's last entity
+ *                  into that index.
+ */
+template <typename RemoveAt>
+void flush_destroyed_entities(handle_table_data &table, RemoveAt remove_at) {
+    for (entity_handle handle : table.pending) {
+        int index = handle_index(table, handle);
+        if (index >= 0) {
+            remove_at(index);
+            handle_table_remove_index(table, index);
+        }
+    }
+    table.pending.clear();
+}
+
+#endif // HANDLE_TABLE_H
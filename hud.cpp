@@ -1,10 +1,16 @@
-#include "splashkit.h"
+#include "platform.h"
+#include "atlas.h"
 #include "hud.h"
 #include "lost_in_space.h"
 #include "game_data.h"
 #include "enemy.h"
 #include "power_up.h"
+#include "profiler.h"
+#include "frame_limiter.h"
+#include "sprites.h"
+#include <cstdio>
 #include <algorithm>
+#include <cmath>
 #include <unordered_map>
 
 /**
@@ -47,40 +53,48 @@ point_2d mini_map_coordinate(const sprite& entity, const game_data& game, int mi
 }
 
 /**
- * Draw an entity on the mini-map as a filled circle.
+ * Transform world positions to mini-map coordinates in place, computing the
+ * scale once for the whole batch.
  *
- * @param entity_sprite The sprite representing the entity to be drawn.
- * @param game The game_data object containing the game-related information.
- * @param entity_color The color to be used for drawing the entity.
- * @param mini_map The MiniMap object containing information about the mini-map.
+ * @param points The world positions, replaced by their mini-map coordinates.
+ * @param game The game_data object containing the map dimensions.
+ * @param mini_map_width The width of the mini-map.
+ * @param mini_map_height The height of the mini-map.
  */
-void draw_entity_on_minimap(const sprite& entity_sprite, const game_data& game, color entity_color, const MiniMap& mini_map) {
-    point_2d entity_point = mini_map_coordinate(entity_sprite, game, mini_map.width, mini_map.height);
-    fill_circle(entity_color, entity_point.x + mini_map.x, entity_point.y + mini_map.y, 3, option_to_screen());
+void mini_map_transform(std::vector<point_2d>& points, const game_data& game, int mini_map_width, int mini_map_height) {
+    double scale_x = calculate_scale(game.map_width, mini_map_width);
+    double scale_y = calculate_scale(game.map_height, mini_map_height);
+
+    for (point_2d& point : points) {
+        point.x = (point.x + game.map_width) * scale_x;
+        point.y = (point.y + game.map_height) * scale_y;
+    }
 }
 
 /**
- * Draw the radar pulse around the player on the mini-map.
+ * Returns the current radius of the radar pulse, which grows from the player
+ * to the edge of the mini-map once every RADAR_PULSE_DURATION of real time.
  *
- * @param player_point The 2D point representing the player's position on the mini-map.
  * @param mini_map The MiniMap object containing information about the mini-map.
+ * @param real_ms The real time from the game clock.
  * @return The radius of the radar pulse.
  */
-double draw_radar_pulse(const point_2d& player_point, const MiniMap& mini_map) {
-    static clock_t radar_pulse_start_time = clock();
-    double elapsed_time = static_cast<double>(clock() - radar_pulse_start_time) / CLOCKS_PER_SEC * 1000;
+double radar_pulse_radius(const MiniMap& mini_map, double real_ms) {
+    double elapsed_time = std::fmod(real_ms, RADAR_PULSE_DURATION);
     double max_pulse_radius = std::min(mini_map.width, mini_map.height) / 2.0;
-    double pulse_radius = (elapsed_time / RADAR_PULSE_DURATION) * max_pulse_radius;
-
-    // Reset the radar pulse start time if the duration has passed
-    if (elapsed_time >= RADAR_PULSE_DURATION) {
-        radar_pulse_start_time = clock();
-    }
+    return (elapsed_time / RADAR_PULSE_DURATION) * max_pulse_radius;
+}
 
+/**
+ * Draw the radar pulse around the player on the mini-map.
+ *
+ * @param player_point The 2D point representing the player's position on the mini-map.
+ * @param mini_map The MiniMap object containing information about the mini-map.
+ * @param pulse_radius The radius of the radar pulse.
+ */
+void draw_radar_pulse(const point_2d& player_point, const MiniMap& mini_map, double pulse_radius) {
     color radar_pulse_color = rgba_color(0, 255, 0, 64);
     draw_circle(radar_pulse_color, player_point.x + mini_map.x, player_point.y + mini_map.y, pulse_radius, option_to_screen());
-
-    return pulse_radius;
 }
 
 /**
@@ -107,30 +121,61 @@ double calculate_alpha(double distance) {
  * @param game The game_data object containing game-related information.
  */
 void draw_mini_map(const player_data& player, const std::vector<enemy_data>& enemies, const std::vector<power_up_data>& power_ups, const game_data& game) {
+    profile_scope scope(ZONE_DRAW_MINI_MAP);
+    static mini_map_cache_data cache = {};
     MiniMap mini_map(MINI_MAP_X, screen_height() - MINI_MAP_HEIGHT - 10, MINI_MAP_WIDTH, MINI_MAP_HEIGHT);
 
-    // Draw the semi-transparent mini map background
-    color semi_transparent_bg = rgba_color(204, 204, 255, 128);
-    fill_rectangle(semi_transparent_bg, mini_map.x, mini_map.y, mini_map.width, mini_map.height, option_to_screen());
-
-    // Draw the player as a green dot
     point_2d player_point = mini_map_coordinate(player.player_sprite, game, mini_map.width, mini_map.height);
-    draw_entity_on_minimap(player.player_sprite, game, COLOR_GREEN, mini_map);
+    double pulse_radius = radar_pulse_radius(mini_map, game.clock.real_ms);
+
+    bool dirty = cache.layer == nullptr;
+    if (dirty) {
+        cache.layer = create_bitmap("mini_map_layer", mini_map.width, mini_map.height);
+    }
+
+    unsigned int now = game.clock.real_ms;
+    if (dirty || now - cache.refresh_tick >= MINI_MAP_REFRESH_INTERVAL) {
+        cache.refresh_tick = now;
+        drawing_options to_layer = option_draw_to(cache.layer);
+
+        // Draw the semi-transparent mini map background
+        clear_bitmap(cache.layer, rgba_color(0, 0, 0, 0));
+        color semi_transparent_bg = rgba_color(204, 204, 255, 128);
+        fill_rectangle(semi_transparent_bg, 0, 0, mini_map.width, mini_map.height, to_layer);
 
-    // Draw the radar pulse around the player
-    double pulse_radius = draw_radar_pulse(player_point, mini_map);  // Update to return pulse_radius
+        // Gather every position first, then transform them in one pass
+        cache.enemy_points.clear();
+        for (const enemy_data& enemy : enemies) {
+            cache.enemy_points.push_back(point_at(sprite_x(enemy.enemy_sprite), sprite_y(enemy.enemy_sprite)));
+        }
+        cache.power_up_points.clear();
+        for (const power_up_data& power_up : power_ups) {
+            cache.power_up_points.push_back(point_at(sprite_x(power_up.power_up_sprite), sprite_y(power_up.power_up_sprite)));
+        }
+        mini_map_transform(cache.enemy_points, game, mini_map.width, mini_map.height);
+        mini_map_transform(cache.power_up_points, game, mini_map.width, mini_map.height);
+
+        // Draw power-ups as yellow dots
+        for (const point_2d& point : cache.power_up_points) {
+            fill_circle(COLOR_YELLOW, point.x, point.y, 2, to_layer);
+        }
 
-    // Draw enemies as red dots with fading effect based on radar range
-    for (const auto &enemy : enemies) {
-        point_2d enemy_point = mini_map_coordinate(enemy.enemy_sprite, game, mini_map.width, mini_map.height);
-        double distance = distance_between_points(player_point, enemy_point);
+        // Draw enemies as red dots with fading effect based on radar range
+        for (const point_2d& point : cache.enemy_points) {
+            double distance = distance_between_points(player_point, point);
 
-        if (distance <= pulse_radius) {
-            double alpha = calculate_alpha(distance);
-            color enemy_color = rgba_color(255.0, 0.0, 0.0, alpha);
-            draw_entity_on_minimap(enemy.enemy_sprite, game, enemy_color, mini_map);
+            if (distance <= pulse_radius) {
+                double alpha = calculate_alpha(distance);
+                fill_circle(rgba_color(255.0, 0.0, 0.0, alpha), point.x, point.y, 3, to_layer);
+            }
         }
     }
+
+    draw_bitmap(cache.layer, mini_map.x, mini_map.y, option_to_screen());
+
+    // Draw the player as a green dot and the radar pulse around it on top of the layer
+    fill_circle(COLOR_GREEN, player_point.x + mini_map.x, player_point.y + mini_map.y, 3, option_to_screen());
+    draw_radar_pulse(player_point, mini_map, pulse_radius);
 }
 
 
@@ -150,41 +195,120 @@ double distance_between_points(const point_2d &point1, const point_2d &point2) {
 /**
  * Draw an item in the heads-up display (HUD).
  *
- * @param bitmap_name The name of the bitmap to draw.
+ * @param image The bitmap to draw.
  * @param value The value associated with the item.
  * @param x The x-coordinate of the item.
  * @param y The y-coordinate of the item.
  * @param x1 The x-coordinate of the value text.
  * @param y1 The y-coordinate of the value text.
+ * @param opts Where to draw.
  */
-void draw_hud_item(const std::string& bitmap_name, const std::string& value, int x, int y, int x1, int y1) {
-    // Draw the bitmap
-    draw_bitmap(bitmap_name, x, y, option_to_screen());
+void draw_hud_item(bitmap image, const std::string& value, int x, int y, int x1, int y1, drawing_options opts) {
+    // Draw the bitmap from the atlas
+    draw_atlas_image(image, { 0, 0, static_cast<double>(bitmap_width(image)), static_cast<double>(bitmap_height(image)) }, x, y, opts);
     
     // Draw the value text
-    draw_text(value, COLOR_SNOW, x1, y1, option_to_screen());
+    draw_text(value, COLOR_SNOW, x1, y1, opts);
 }
 
 /**
  * Draw a bar in the heads-up display (HUD).
  *
- * @param empty_bitmap The name of the bitmap for the empty part of the bar.
- * @param filled_bitmap The name of the bitmap for the filled part of the bar.
+ * @param empty_bitmap The bitmap for the empty part of the bar.
+ * @param filled_bitmap The bitmap for the filled part of the bar.
  * @param x The x-coordinate of the bar.
  * @param y The y-coordinate of the bar.
  * @param width The width of the bar.
- * @param pct The percentage filled of the bar.
+ * @param filled_width The width of the filled part of the bar.
+ * @param opts Where to draw.
  */
-void draw_hud_bar(const std::string& empty_bitmap, const std::string& filled_bitmap, int x, int y, int width, double pct) {
-    int part_width = width * pct;
+void draw_hud_bar(bitmap empty_bitmap, bitmap filled_bitmap, int x, int y, int width, int filled_width, drawing_options opts) {
+    double height = bitmap_height(filled_bitmap);
     
     // Draw the empty bar
-    draw_bitmap(empty_bitmap, x, y, option_part_bmp(0, 0, width, bitmap_height(filled_bitmap), option_to_screen()));
+    draw_atlas_image(empty_bitmap, { 0, 0, static_cast<double>(width), height }, x, y, opts);
     
     // Draw the filled bar
-    draw_bitmap(filled_bitmap, x, y, option_part_bmp(0, 0, part_width, bitmap_height(filled_bitmap), option_to_screen()));
+    draw_atlas_image(filled_bitmap, { 0, 0, static_cast<double>(filled_width), height }, x, y, opts);
 }
 
+// The cached HUD layer, created by the first draw_hud
+static hud_cache_data hud_cache = {};
+
+/**
+ * Create the HUD layer bitmap and look up the HUD images.
+ *
+ * @param cache The HUD cache to set up.
+ */
+void create_hud_layer(hud_cache_data& cache) {
+    cache.layer = create_bitmap("hud_layer", screen_width(), HUD_LAYER_HEIGHT);
+    cache.kill_count_icon = bitmap_named("kill_count");
+    cache.rocket_icon = bitmap_named("HUD_bullet");
+    cache.time_icon = bitmap_named("HUD_time");
+    cache.empty_bar = bitmap_named("empty");
+    cache.fuel_bar = bitmap_named("full");
+    cache.shield_bar = bitmap_named("purple_bar");
+}
+
+/**
+ * Re-render the HUD layer from the values stored in the cache.
+ *
+ * @param cache The HUD cache to render.
+ * @param bar_x The x-coordinate of the fuel and shield bars.
+ * @param bar_width The width of the fuel and shield bars.
+ */
+void render_hud_layer(const hud_cache_data& cache, int bar_x, int bar_width) {
+    drawing_options to_layer = option_draw_to(cache.layer);
+    clear_bitmap(cache.layer, rgba_color(0, 0, 0, 0));
+
+    // Draw Player Location
+    draw_text(cache.location, COLOR_SNOW, 20, 20, to_layer);
+
+    // Draw other HUD items
+    draw_hud_item(cache.kill_count_icon, std::to_string(cache.kill_count), 20, 40, 50, 50, to_layer);
+    draw_hud_item(cache.rocket_icon, std::to_string(cache.rocket_count), 20, 70, 50, 80, to_layer);
+    draw_hud_item(cache.time_icon, std::to_string(cache.time_remaining), 20, 100, 50, 110, to_layer);
+
+    // Draw the fuel gauge bar
+    draw_hud_bar(cache.empty_bar, cache.fuel_bar, bar_x, 10, bar_width, cache.fuel_width, to_layer);
+
+    // Draw the shield gauge bar
+    draw_hud_bar(cache.empty_bar, cache.shield_bar, bar_x, 60, bar_width, cache.shield_width, to_layer);
+}
+
+
+/**
+ * Draw the performance panel below the fuel and shield bars.
+ * Times come from the last completed profiler frame.
+ *
+ * @param game The game_data object containing game-related information.
+ */
+void draw_performance_overlay(const game_data& game) {
+    const int panel_x = 560;
+    const int panel_y = 110;
+    const int line_height = 14;
+
+    char lines[10][48];
+    snprintf(lines[0], sizeof(lines[0]), "FRAME:       %6.2f ms", profiler_last_frame_ms(ZONE_FRAME));
+    snprintf(lines[1], sizeof(lines[1]), "UPDATE:      %6.2f ms", profiler_last_frame_ms(ZONE_UPDATE));
+    snprintf(lines[2], sizeof(lines[2]), "DRAW:        %6.2f ms", profiler_last_frame_ms(ZONE_DRAW));
+    snprintf(lines[3], sizeof(lines[3]), "ENEMIES:     %6zu", game.enemies.size());
+    snprintf(lines[4], sizeof(lines[4]), "PROJECTILES: %6d", projectile_count(game.projectiles));
+    snprintf(lines[5], sizeof(lines[5]), "POWER-UPS:   %6zu", game.power_ups.size());
+    snprintf(lines[6], sizeof(lines[6]), "EXPLOSIONS:  %6d", explosion_count(game.explosions));
+    snprintf(lines[7], sizeof(lines[7]), "PLANETS:     %6zu", game.planets.size());
+    snprintf(lines[8], sizeof(lines[8]), "SPRITES:     %6d", live_sprite_count());
+    snprintf(lines[9], sizeof(lines[9]), "MISSED:      %6ld", frame_limiter_missed_count());
+
+    // Draw a dark backing so the text stays readable over the background
+    fill_rectangle(rgba_color(0, 0, 0, 160), panel_x - 5, panel_y - 5, 235, 10 * line_height + 10, option_to_screen());
+
+    for (int i = 0; i < 10; i++) {
+        // Highlight the frame time when it is over budget
+        color text_color = (i == 0 && profiler_last_frame_ms(ZONE_FRAME) > FRAME_BUDGET_MS) ? COLOR_YELLOW : COLOR_SNOW;
+        draw_text(lines[i], text_color, panel_x, panel_y + i * line_height, option_to_screen());
+    }
+}
 
 /**
  * Draw the heads-up display (HUD) elements on the screen.
@@ -194,26 +318,48 @@ void draw_hud_bar(const std::string& empty_bitmap, const std::string& filled_bit
  * @param game The game_data object containing game-related information.
  */
 void draw_hud(const player_data &player, const std::vector<enemy_data> &enemies, const game_data &game) {
-    // Draw Player Location
-    std::string location_str = "LOCATION: " + point_to_string(center_point(player.player_sprite));
-    draw_text(location_str, COLOR_SNOW, 20, 20, option_to_screen());
-
-    // Draw other HUD items
-    draw_hud_item("kill_count", std::to_string(player.kill_count), 20, 40, 50, 50);
-    draw_hud_item("HUD_bullet", std::to_string(player.rocket_count), 20, 70, 50, 80);
-    draw_hud_item("HUD_time", std::to_string(player.time_remaining), 20, 100, 50, 110);
-
     // Right align fuel and shield bars
     int bar_width = 300;
     int bar_x = 500;
 
-    // Draw the fuel gauge bar
-    draw_hud_bar("empty", "full", bar_x, 10, bar_width, player.fuel_pct);
+    bool dirty = false;
+    if (hud_cache.layer == nullptr) {
+        create_hud_layer(hud_cache);
+        dirty = true;
+    }
 
-    // Draw the shield gauge bar
-    draw_hud_bar("empty", "purple_bar", bar_x, 60, bar_width, player.shield_pct);
+    // Refresh the location text at most every HUD_LOCATION_INTERVAL
+    unsigned int now = game.clock.real_ms;
+    if (dirty || now - hud_cache.location_tick >= HUD_LOCATION_INTERVAL) {
+        std::string location_str = "LOCATION: " + point_to_string(center_point(player.player_sprite));
+        dirty = dirty || location_str != hud_cache.location;
+        hud_cache.location = location_str;
+        hud_cache.location_tick = now;
+    }
+
+    // Re-render the layer only when a value it shows has changed
+    int fuel_width = bar_width * player.fuel_pct;
+    int shield_width = bar_width * player.shield_pct;
+    if (dirty || player.kill_count != hud_cache.kill_count || player.rocket_count != hud_cache.rocket_count ||
+        player.time_remaining != hud_cache.time_remaining || fuel_width != hud_cache.fuel_width ||
+        shield_width != hud_cache.shield_width) {
+        hud_cache.kill_count = player.kill_count;
+        hud_cache.rocket_count = player.rocket_count;
+        hud_cache.time_remaining = player.time_remaining;
+        hud_cache.fuel_width = fuel_width;
+        hud_cache.shield_width = shield_width;
+        render_hud_layer(hud_cache, bar_x, bar_width);
+    }
+
+    // Draw the cached layer
+    draw_bitmap(hud_cache.layer, 0, 0, option_to_screen());
 
     // Draw the mini-map
     draw_mini_map(player, enemies, game.power_ups, game);
+
+    // Draw the performance panel when toggled on with F3
+    if (game.show_performance_overlay) {
+        draw_performance_overlay(game);
+    }
 }
 
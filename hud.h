@@ -7,6 +7,34 @@
 #include "enemy.h"
 #include "power_up.h"
 
+// Height of the off-screen HUD layer, covering the items and bars at the top of the screen
+const int HUD_LAYER_HEIGHT = 140;
+
+// Time between refreshes of the location text, in milliseconds
+const unsigned int HUD_LOCATION_INTERVAL = 250;
+
+/**
+ * The HUD items, bars and location text, rendered into an off-screen bitmap.
+ * The layer is only re-rendered when one of the values it shows changes, and
+ * is otherwise drawn to the screen with a single blit.
+ */
+struct hud_cache_data {
+    bitmap layer;                   // The off-screen HUD bitmap, or nullptr until first drawn
+    bitmap kill_count_icon;         // HUD images, looked up once when the layer is created
+    bitmap rocket_icon;
+    bitmap time_icon;
+    bitmap empty_bar;
+    bitmap fuel_bar;
+    bitmap shield_bar;
+    int kill_count;                 // Values shown in the layer
+    int rocket_count;
+    int time_remaining;
+    int fuel_width;                 // Filled widths of the bars in pixels
+    int shield_width;
+    std::string location;           // Location text shown in the layer
+    unsigned int location_tick;     // When the location text was last refreshed
+};
+
 // Structure to represent the mini-map on the screen
 struct MiniMap {
     int x;      // X-coordinate of the mini-map
@@ -18,6 +46,32 @@ struct MiniMap {
         : x(x), y(y), width(width), height(height) {}
 };
 
+// Time between re-renders of the mini-map layer, in milliseconds (about 12 Hz)
+const unsigned int MINI_MAP_REFRESH_INTERVAL = 80;
+
+/**
+ * The mini-map background and entity dots, rendered into an off-screen bitmap
+ * every MINI_MAP_REFRESH_INTERVAL. The player dot and radar pulse are drawn
+ * on top of it every frame.
+ */
+struct mini_map_cache_data {
+    bitmap layer;                           // The off-screen mini-map bitmap, or nullptr until first drawn
+    unsigned int refresh_tick;              // When the layer was last rendered
+    std::vector<point_2d> enemy_points;     // Scratch space for the batched transform
+    std::vector<point_2d> power_up_points;
+};
+
+/**
+ * Transform world positions to mini-map coordinates in place, computing the
+ * scale once for the whole batch.
+ *
+ * @param points The world positions, replaced by their mini-map coordinates.
+ * @param game The game_data object containing the map dimensions.
+ * @param mini_map_width The width of the mini-map.
+ * @param mini_map_height The height of the mini-map.
+ */
+void mini_map_transform(std::vector<point_2d>& points, const game_data& game, int mini_map_width, int mini_map_height);
+
 /**
  * Calculate the scale factor for mapping coordinates from the game map to the mini-map.
  *
@@ -56,18 +110,9 @@ point_2d mini_map_coordinate(const sprite& entity, const game_data& game, int mi
  */
 double calculate_alpha(double distance);
 
-/**
- * Draw an entity on the mini-map as a filled circle.
- *
- * @param entity_sprite The sprite representing the entity to be drawn.
- * @param game The game_data object containing the game-related information.
- * @param entity_color The color to be used for drawing the entity.
- * @param mini_map The MiniMap object containing information about the mini-map.
- */
-void draw_entity_on_minimap(const sprite& entity_sprite, const game_data& game, color entity_color, const MiniMap& mini_map);
-
 /**
  * Draw the mini-map on the screen.
+ * Enemies within the radar pulse are shown in red and power-ups in yellow.
  *
  * @param player The player_data object containing player-related information.
  * @param enemies The vector of enemy_data objects containing enemy-related information.
@@ -79,29 +124,41 @@ void draw_mini_map(const player_data& player, const std::vector<enemy_data>& ene
 /**
  * Draw an item in the heads-up display (HUD).
  *
- * @param bitmap_name The name of the bitmap to draw.
+ * @param image The bitmap to draw.
  * @param value The value associated with the item.
  * @param x The x-coordinate of the item.
  * @param y The y-coordinate of the item.
  * @param x1 The x-coordinate of the value text.
  * @param y1 The y-coordinate of the value text.
+ * @param opts Where to draw, e.g. option_draw_to the HUD layer.
  */
-void draw_hud_item(const std::string& bitmap_name, const std::string& value, int x, int y, int x1, int y1);
+void draw_hud_item(bitmap image, const std::string& value, int x, int y, int x1, int y1, drawing_options opts);
 
 /**
  * Draw a progress bar on the heads-up display (HUD).
  *
- * @param empty_bitmap The name of the bitmap for the empty part of the bar.
- * @param filled_bitmap The name of the bitmap for the filled part of the bar.
+ * @param empty_bitmap The bitmap for the empty part of the bar.
+ * @param filled_bitmap The bitmap for the filled part of the bar.
  * @param x The x-coordinate of the bar.
  * @param y The y-coordinate of the bar.
  * @param width The width of the bar.
- * @param pct The percentage filled of the bar.
+ * @param filled_width The width of the filled part of the bar.
+ * @param opts Where to draw, e.g. option_draw_to the HUD layer.
+ */
+void draw_hud_bar(bitmap empty_bitmap, bitmap filled_bitmap, int x, int y, int width, int filled_width, drawing_options opts);
+
+/**
+ * Draw the performance panel: frame, update and draw times from the profiler,
+ * the size of every entity container and the number of live sprites.
+ *
+ * @param game The game_data object containing game-related information.
  */
-void draw_hud_bar(const std::string& empty_bitmap, const std::string& filled_bitmap, int x, int y, int width, double pct);
+void draw_performance_overlay(const game_data& game);
 
 /**
  * Draw the heads-up display (HUD) on the screen.
+ * The items, bars and location text come from the cached HUD layer, which
+ * is re-rendered only when the values it shows change.
  *
  * @param player The player_data object containing player-related information.
  * @param enemies The vector of enemy_data objects containing enemy-related information.
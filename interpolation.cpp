@@ -0,0 +1,93 @@
+#include "platform.h"
+#include "interpolation.h"
+#include "game_data.h"
+
+// Where the simulation left each interpolated sprite, in the order apply_interpolated_positions visits them
+static vector<point_2d> simulated_positions;
+
+// Where the simulation left the camera
+static point_2d simulated_camera;
+
+/**
+ * Returns the point a given fraction of the way from one point to another.
+ *
+ * @param from The point at alpha 0.
+ * @param to The point at alpha 1.
+ * @param alpha The fraction of the way to go.
+ * @return The interpolated point.
+ */
+point_2d lerp_point(const point_2d &from, const point_2d &to, double alpha) {
+    return point_at(from.x + (to.x - from.x) * alpha, from.y + (to.y - from.y) * alpha);
+}
+
+/**
+ * Remember the positions of the moving sprites and the camera before a simulation step.
+ *
+ * @param game The game about to be stepped.
+ */
+void save_previous_positions(game_data &game) {
+    game.player.previous_position = sprite_position(game.player.player_sprite);
+
+    for (enemy_data &enemy : game.enemies) {
+        enemy.previous_position = sprite_position(enemy.enemy_sprite);
+    }
+    for (power_up_data &power_up : game.power_ups) {
+        power_up.previous_position = sprite_position(power_up.power_up_sprite);
+    }
+
+    game.previous_camera = point_at(camera_x(), camera_y());
+}
+
+/**
+ * Remember where the simulation left a sprite and move it to its interpolated position.
+ *
+ * @param s The sprite to move.
+ * @param previous The sprite's position before the last step.
+ * @param alpha How far between the previous and the latest step to draw.
+ */
+static void interpolate_sprite(sprite s, const point_2d &previous, double alpha) {
+    point_2d current = sprite_position(s);
+    simulated_positions.push_back(current);
+    sprite_set_position(s, lerp_point(previous, current, alpha));
+}
+
+/**
+ * Move the sprites and the camera to their interpolated positions for drawing.
+ *
+ * @param game The game being drawn.
+ * @param alpha How far between the previous and the latest step to draw.
+ */
+void apply_interpolated_positions(const game_data &game, double alpha) {
+    simulated_positions.clear();
+
+    interpolate_sprite(game.player.player_sprite, game.player.previous_position, alpha);
+    for (const enemy_data &enemy : game.enemies) {
+        interpolate_sprite(enemy.enemy_sprite, enemy.previous_position, alpha);
+    }
+    for (const power_up_data &power_up : game.power_ups) {
+        interpolate_sprite(power_up.power_up_sprite, power_up.previous_position, alpha);
+    }
+
+    simulated_camera = point_at(camera_x(), camera_y());
+    point_2d camera = lerp_point(game.previous_camera, simulated_camera, alpha);
+    set_camera_position(camera);
+}
+
+/**
+ * Move the sprites and the camera back to where the simulation left them.
+ *
+ * @param game The game that was drawn.
+ */
+void restore_simulated_positions(const game_data &game) {
+    size_t next = 0;
+
+    sprite_set_position(game.player.player_sprite, simulated_positions[next++]);
+    for (const enemy_data &enemy : game.enemies) {
+        sprite_set_position(enemy.enemy_sprite, simulated_positions[next++]);
+    }
+    for (const power_up_data &power_up : game.power_ups) {
+        sprite_set_position(power_up.power_up_sprite, simulated_positions[next++]);
+    }
+
+    set_camera_position(simulated_camera);
+}
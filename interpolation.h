@@ -0,0 +1,52 @@
+#ifndef INTERPOLATION_H
+#define INTERPOLATION_H
+
+#include "platform.h"
+
+struct game_data;
+
+/**
+ * Render interpolation between the last two simulation steps.
+ *
+ * The simulation runs in fixed steps, so a frame usually falls between two of
+ * them. Before each step the player, enemy and power-up positions and the
+ * camera are remembered; when drawing, the sprites and camera are moved to
+ * the point between the remembered and the current positions given by the
+ * clock's alpha, and moved back once the frame is drawn. Projectiles move in
+ * straight lines and are drawn back along their velocity instead.
+ */
+
+/**
+ * Remember the positions of the moving sprites and the camera before a simulation step.
+ *
+ * @param game The game about to be stepped.
+ */
+void save_previous_positions(game_data &game);
+
+/**
+ * Move the sprites and the camera to their interpolated positions for drawing.
+ * Must be followed by restore_simulated_positions once the frame is drawn.
+ *
+ * @param game The game being drawn.
+ * @param alpha How far between the previous and the latest step to draw, from 0 to 1.
+ */
+void apply_interpolated_positions(const game_data &game, double alpha);
+
+/**
+ * Move the sprites and the camera back to where the simulation left them.
+ *
+ * @param game The game that was drawn.
+ */
+void restore_simulated_positions(const game_data &game);
+
+/**
+ * Returns the point a given fraction of the way from one point to another.
+ *
+ * @param from The point at alpha 0.
+ * @param to The point at alpha 1.
+ * @param alpha The fraction of the way to go.
+ * @return The interpolated point.
+ */
+point_2d lerp_point(const point_2d &from, const point_2d &to, double alpha);
+
+#endif // INTERPOLATION_H
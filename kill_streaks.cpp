@@ -1,4 +1,4 @@
-#include "splashkit.h"
+#include "platform.h"
 #include "game_data.h"
 #include "kill_streaks.h"
 
@@ -78,7 +78,7 @@ void activate_ultimate_kill_streak(game_data& game) {
     }
 
     game.is_kill_streak_active = true; // Activate kill streak
-    game.last_kill_streak_tick = timer_ticks(game.game_timer); // Start the kill streak
+    game.last_kill_streak_tick = game_clock_ticks(game.clock); // Start the kill streak
 }
 
 /**
@@ -96,7 +96,7 @@ void end_ultimate_kill_streak(game_data& game) {
     }
 
     game.is_kill_streak_active = false; // Deactivate kill streak
-    game.last_kill_streak_tick = timer_ticks(game.game_timer); // End the kill streak
+    game.last_kill_streak_tick = game_clock_ticks(game.clock); // End the kill streak
     stop_music(); // Stop the kill streak music
 }
 
@@ -107,7 +107,7 @@ void end_ultimate_kill_streak(game_data& game) {
  * @return True if the kill streak should end, false otherwise.
  */
 bool should_end_kill_streak(const game_data& game) {
-    return game.is_kill_streak_active && timer_ticks(game.game_timer) - game.last_kill_streak_tick >= 15000;
+    return game.is_kill_streak_active && game_clock_ticks(game.clock) - game.last_kill_streak_tick >= 15000;
 }
 
 /**
@@ -1,4 +1,4 @@
-#include "splashkit.h"
+#include "platform.h"
 #include "enemy.h"
 #include "game_data.h"
 #include "player.h"
@@ -9,6 +9,10 @@
 #include "kill_streaks.h"
 #include "explosion.h"
 #include "collision.h"
+#include "profiler.h"
+#include "view_culling.h"
+#include "atlas.h"
+#include "interpolation.h"
 
 /**
  * Update the game time remaining by decrementing it by the elapsed time
@@ -18,11 +22,11 @@
  */
 void update_game_time(game_data &game) {
     // Check if a second has passed since the last time the timer ticked
-    if (timer_ticks(game.game_timer) - game.last_second_tick >= 1000) {
+    if (game_clock_ticks(game.clock) - game.last_second_tick >= 1000) {
         // Decrement the remaining time for the player
         game.player.time_remaining--;
         // Update the last second tick to the current timer value
-        game.last_second_tick = timer_ticks(game.game_timer);
+        game.last_second_tick = game_clock_ticks(game.clock);
     }
 
     // Check if the player has run out of time
@@ -39,7 +43,7 @@ void update_game_time(game_data &game) {
 */
 bool should_spawn_power_up(game_data &game) {
     // Check if the time interval for power-up spawning has passed
-    return timer_ticks(game.game_timer) - game.last_power_up_spawn_tick >= game.power_up_spawn_interval;
+    return game_clock_ticks(game.clock) - game.last_power_up_spawn_tick >= game.power_up_spawn_interval;
 }
 
 /**
@@ -58,6 +62,9 @@ void update_start_menu(game_data &game) {
     if (key_typed(RETURN_KEY)) {
         play_sound_effect("letsgo");
         game.state = game_state::IN_PROGRESS;
+
+        // Time spent on the menu is not game time
+        discard_game_clock_backlog(game.clock);
         
         // Reset the intro_music_started variable
         game.intro_music_started = false;
@@ -72,54 +79,85 @@ void update_start_menu(game_data &game) {
  * @param time_delta The time difference between frames.
  */
 void update_in_progress(game_data &game, double time_delta) {
-    update_player(game.player, time_delta);
+    // Each subsystem is timed in its own profiler zone
+    {
+        profile_scope scope(ZONE_UPDATE_PLAYER);
+        update_player(game.player, time_delta);
+    }
 
     // Update power-ups
-    for (power_up_data &power_up : game.power_ups) {
-        update_power_up(power_up);
+    {
+        profile_scope scope(ZONE_UPDATE_POWER_UPS);
+        update_power_ups(game);
     }
 
     // Update planets
-    for (planet_data &planet : game.planets) {
-        update_planet(planet);
+    {
+        profile_scope scope(ZONE_UPDATE_PLANETS);
+        for (planet_data &planet : game.planets) {
+            update_planet(planet);
+        }
     }
 
-    // Spawn 10 power-ups every 20 seconds
-    spawn_power_ups(game);
+    {
+        profile_scope scope(ZONE_SPAWNING);
 
-    // Spawn 1 enemy every 10 seconds
-    spawn_enemy(game);
+        // Spawn 10 power-ups every 20 seconds
+        spawn_power_ups(game);
+
+        // Spawn 1 enemy every 10 seconds
+        spawn_enemy(game);
+    }
 
     // Update projectiles
-    for (projectile_data &projectile : game.projectiles) {
-        update_projectile(projectile, time_delta);
+    {
+        profile_scope scope(ZONE_UPDATE_PROJECTILES);
+        update_projectiles(game.projectiles, time_delta);
     }
 
     // Check for collisions between player's projectiles and enemies
-    check_player_projectile_collisions(game);
+    {
+        profile_scope scope(ZONE_PLAYER_PROJECTILE_COLLISIONS);
+        check_player_projectile_collisions(game);
+    }
 
     // Update enemies
-    update_enemies(game);
+    {
+        profile_scope scope(ZONE_UPDATE_ENEMIES);
+        update_enemies(game);
+    }
 
     // Check for collisions between enemies' projectiles and player
-    check_enemy_projectile_collisions(game);
-
-    // Update explosions
-    for (explosion_data &explosion : game.explosions) {
-        update_explosion(explosion);
+    {
+        profile_scope scope(ZONE_ENEMY_PROJECTILE_COLLISIONS);
+        check_enemy_projectile_collisions(game);
     }
 
-    // Update and remove expired explosions
-    update_explosions(game);
+    {
+        profile_scope scope(ZONE_UPDATE_EXPLOSIONS);
 
-    // Add a new planet
-    add_planet(game);
+        // Remove the explosions that have finished
+        update_explosions(game);
+    }
 
     // Check for collisions between power-ups and player
-    check_player_power_up_collisions(game);
+    {
+        profile_scope scope(ZONE_POWER_UP_COLLISIONS);
+        check_player_power_up_collisions(game);
+    }
 
     // Update kill streaks
-    update_kill_streaks(game);
+    {
+        profile_scope scope(ZONE_KILL_STREAKS);
+        update_kill_streaks(game);
+    }
+
+    // Remove the enemies and projectiles destroyed during the frame
+    {
+        profile_scope scope(ZONE_FLUSH_DESTROYED);
+        flush_destroyed_enemies(game);
+        flush_destroyed_projectiles(game.projectiles);
+    }
 }
 
 
@@ -138,13 +176,20 @@ void update_game_over(game_data &game) {
  * @param game The game_data object containing the game state.
  */
 void update_game(game_data &game) {
-    double time_delta = 1.0 / 60.0;  
+    profile_scope scope(ZONE_UPDATE);
+    tick_game_clock(game.clock);
+
     switch (game.state) {
         case game_state::START_MENU:
             update_start_menu(game);
             break;
         case game_state::IN_PROGRESS:
-            update_in_progress(game, time_delta);
+            // Run as many fixed steps as the clock has accumulated; none while paused
+            while (game.state == game_state::IN_PROGRESS && game_clock_step(game.clock)) {
+                save_previous_positions(game);
+                handle_steering(game);
+                update_in_progress(game, GAME_CLOCK_STEP);
+            }
             break;
         case game_state::GAME_OVER:
             update_game_over(game);
@@ -155,8 +200,8 @@ void update_game(game_data &game) {
 // Function to add a new enemy to the game
 void add_enemy(game_data &game) {
     // Choose a random enemy type
-    enemy_kind kind = static_cast<enemy_kind>(rnd(3));
-    game.enemies.push_back(new_enemy(kind, game.player, game.enemies));
+    enemy_kind kind = static_cast<enemy_kind>(rng_int(game.rng, 3));
+    insert_enemy(game, new_enemy(kind, game.player, game.enemies, game.rng));
 }
 
 /**
@@ -177,59 +222,116 @@ void draw_start_menu(const game_data &game) {
 
 
 /**
- * Draw the game in progress.
+ * Draw the game in progress, interpolated between the last two simulation
+ * steps. Only the entities that cull_to_view finds in view are drawn. Sprites are queued as atlas quads and drawn by
+ * flush_draw_batch in texture order, once before the projectiles and once after the explosions. SplashKit has no batch
+ * API, so the flush still makes one draw call per quad.
  *
  * @param game The game_data object containing the game state.
  */
 void draw_in_progress(const game_data &game) {
+    // Entities overlapping the view this frame, kept between frames so the lists reuse their memory
+    static visible_lists_data visible;
+
+    // Draw between the last two simulation steps; projectiles are drawn back along their velocity by the time still to come
+    double alpha = game_clock_alpha(game.clock);
+    double projectile_lag = (1.0 - alpha) * GAME_CLOCK_STEP;
+    apply_interpolated_positions(game, alpha);
+
     // draw background for game
     draw_bitmap("space", 0, 0, option_to_screen());
+
+    {
+        profile_scope scope(ZONE_CULL_VIEW);
+        cull_to_view(game, visible);
+    }
     
-    for (const auto &planet : game.planets) {
-        draw_planet(planet);
+    {
+        profile_scope scope(ZONE_DRAW_PLANETS);
+        for (int index : visible.planets) {
+            draw_planet(game.planets[index]);
+        }
+    }
+
+    {
+        profile_scope scope(ZONE_DRAW_PLAYER);
+        draw_player(game.player);
+    }
+
+    {
+        profile_scope scope(ZONE_DRAW_ENEMIES);
+        draw_enemies(game, visible.enemies);
+    }
+
+    {
+        profile_scope scope(ZONE_DRAW_POWER_UPS);
+        for (int index : visible.power_ups) {
+            draw_power_up(game.power_ups[index]);
+        }
     }
 
-    draw_player(game.player);
+    // Draw the planets, player, enemies and power-ups before the projectiles are drawn over them
+    {
+        profile_scope scope(ZONE_FLUSH_DRAW_BATCH);
+        flush_draw_batch();
+    }
 
-    draw_enemies(game);
+    {
+        profile_scope scope(ZONE_DRAW_PROJECTILES);
+        draw_projectiles(game.projectiles, visible.projectiles, projectile_lag);
+    }
 
-    for (const auto &power_up : game.power_ups) {
-        draw_power_up(power_up);
+    {
+        profile_scope scope(ZONE_DRAW_EXPLOSIONS);
+        draw_explosions(game.explosions, visible.explosions);
     }
 
-    for (const projectile_data &projectile : game.projectiles) {
-        draw_projectile(projectile);
+    {
+        profile_scope scope(ZONE_FLUSH_DRAW_BATCH);
+        flush_draw_batch();
     }
 
-    for (const explosion_data &explosion : game.explosions) {
-        draw_explosion(explosion);
+    {
+        profile_scope scope(ZONE_DRAW_HUD);
+        draw_hud(game.player, game.enemies, game);
     }
 
-    draw_hud(game.player, game.enemies, game);
+    restore_simulated_positions(game);
+
+    if (game.clock.paused) {
+        draw_text("PAUSED", COLOR_WHITE, screen_width() / 2 - 25, screen_height() / 2, option_to_screen());
+    }
 }
 
 
 /**
- * Draw the game on the screen.
+ * Draw the game on the screen. Presenting the frame is timed in its own
+ * zone, so whatever refresh_screen waits for is not counted as draw time.
  *
  * @param game The game_data object containing the game state.
  */
 void draw_game(const game_data &game) {
-    clear_screen(COLOR_BLACK);
-
-    switch (game.state) {
-        case game_state::START_MENU:
-            draw_start_menu(game);
-            break;
-        case game_state::IN_PROGRESS:
-            draw_in_progress(game);
-            break;
-        case game_state::GAME_OVER:
-            // Do nothing for now
-            break;
+    {
+        profile_scope scope(ZONE_DRAW);
+        clear_screen(COLOR_BLACK);
+
+        switch (game.state) {
+            case game_state::START_MENU:
+                draw_start_menu(game);
+                break;
+            case game_state::IN_PROGRESS:
+                draw_in_progress(game);
+                break;
+            case game_state::GAME_OVER:
+                // Do nothing for now
+                break;
+        }
     }
 
-    refresh_screen(60);
+    {
+        profile_scope scope(ZONE_PRESENT);
+        refresh_screen();
+    }
 }
 
 
@@ -243,7 +345,7 @@ void spawn_power_ups(game_data &game) {
         for (int i = 0; i < 10; ++i) {
             add_power_up(game);
         }
-        game.last_power_up_spawn_tick = timer_ticks(game.game_timer);
+        game.last_power_up_spawn_tick = game_clock_ticks(game.clock);
     }
 }
 
@@ -254,9 +356,9 @@ void spawn_power_ups(game_data &game) {
  * @param game The game_data object to spawn an enemy in.
  */
 void spawn_enemy(game_data &game) {
-    if (timer_ticks(game.game_timer) - game.last_enemy_spawn_tick >= game.enemy_spawn_interval) {
+    if (game_clock_ticks(game.clock) - game.last_enemy_spawn_tick >= game.enemy_spawn_interval) {
         add_enemy(game);
-        game.last_enemy_spawn_tick = timer_ticks(game.game_timer);
+        game.last_enemy_spawn_tick = game_clock_ticks(game.clock);
     }
 }
 
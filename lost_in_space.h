@@ -1,7 +1,7 @@
 #ifndef LOST_IN_SPACE_H
 #define LOST_IN_SPACE_H
 
-#include "splashkit.h"
+#include "platform.h"
 #include "player.h"
 #include "planets.h"
 #include "shooting.h"
@@ -52,16 +52,13 @@ void draw_game(const game_data &game);
 
 /**
  * Updates the game by updating the player and power-up data and checking for collisions.
+ * Ticks the game clock, then runs one update_in_progress per fixed simulation
+ * step it has accumulated; nothing in the game moves while the clock is paused.
  *
  * @param game The game to update.
  */
 void update_game(game_data &game);
 
-/**
- * Adds a new planet to the screen
- */
-void add_planet(game_data &game);
-
 /**
  * Check if a power-up should be spawned.
  *
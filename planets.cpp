@@ -1,9 +1,22 @@
-#include "splashkit.h"
+#include "platform.h"
+#include "atlas.h"
 #include "lost_in_space.h"
 #include "player.h"
 #include "power_up.h"
 #include "planets.h"
+#include "sprites.h"
+#include <algorithm>
+#include <cmath>
 
+// Candidates tried around a point before it is retired from Poisson-disk sampling
+const int POISSON_DISK_CANDIDATES = 30;
+
+/**
+ * Returns the bitmap associated with a planet kind.
+ *
+ * @param kind The kind of planet.
+ * @return The bitmap for the planet kind.
+ */
 bitmap planet_bitmap(planet_kind kind) {
     switch (kind) {
         case MERCURY: 
@@ -28,22 +41,22 @@ bitmap planet_bitmap(planet_kind kind) {
 }
 
 /**
-* Creates a new planet with a random planet bitmap and sets its position and velocity
+* Creates a new planet of the given kind and sets its position
 * @param x: the x coordinate of the planet
 * @param y: the y coordinate of the planet
-* @return: the newly created planet with a random bitmap, position and velocity
+* @param kind: the kind of planet
+* @return: the newly created planet with the kind's bitmap at the given position
 */
 
-planet_data new_planet(double x, double y) {
+planet_data new_planet(double x, double y, planet_kind kind) {
     planet_data result;
-    // Randomly select a planet kind using rnd() function
-    result.kind = static_cast<planet_kind>(rnd(9));
+    result.kind = kind;
 
     // Get the bitmap of the selected planet
     bitmap planet_bmp = planet_bitmap(result.kind);
 
     // Create a sprite for the planet using the bitmap
-    result.planet_sprite = create_sprite(planet_bmp);
+    result.planet_sprite = owned_sprite(planet_bmp);
 
     // Set the position of the sprite using the x and y parameters
     sprite_set_x(result.planet_sprite, x);
@@ -56,7 +69,7 @@ planet_data new_planet(double x, double y) {
  * @param planet_to_draw The planet data containing the sprite to be drawn
  */
 void draw_planet(const planet_data &planet_to_draw) {
-    draw_sprite(planet_to_draw.planet_sprite); // Draw the planet sprite onto the screen
+    queue_sprite_draw(planet_to_draw.planet_sprite, LAYER_PLANETS); // Queue the planet sprite to be drawn
 }
 
 /**
@@ -67,37 +80,120 @@ void update_planet(const planet_data &planet_to_update) {
     update_sprite(planet_to_update.planet_sprite); // Update the planet sprite with its current properties
 }
 
-bool is_unique_kind(const planet_data &planet, const game_data &game) {
-    for (const auto &existing_planet : game.planets) {
-        if (planet.kind == existing_planet.kind) {
-            return false;  // The planet's kind already exists in the game
+/**
+ * Fill a rectangle with points by Poisson-disk sampling (Bridson's
+ * algorithm), so no two points are closer than spacing and no gap is wide
+ * enough for another. A background grid with cells of spacing / sqrt(2)
+ * holds at most one point each, so each candidate is only checked against
+ * the 5x5 cells around it.
+ *
+ * @param min_x The left edge of the rectangle.
+ * @param min_y The top edge of the rectangle.
+ * @param max_x The right edge of the rectangle.
+ * @param max_y The bottom edge of the rectangle.
+ * @param spacing The minimum distance between two points.
+ * @param rng The random number stream used to place the points.
+ * @return The points, in the order they were placed.
+ */
+static vector<point_2d> poisson_disk_points(double min_x, double min_y, double max_x, double max_y,
+                                           double spacing, rng_data &rng) {
+    double cell_size = spacing / sqrt(2.0);
+    int columns = static_cast<int>(ceil((max_x - min_x) / cell_size));
+    int rows = static_cast<int>(ceil((max_y - min_y) / cell_size));
+    vector<int> grid(columns * rows, -1);
+
+    vector<point_2d> points;
+    vector<int> active;
+
+    auto cell_of = [&](const point_2d &pt) {
+        int column = std::min(static_cast<int>((pt.x - min_x) / cell_size), columns - 1);
+        int row = std::min(static_cast<int>((pt.y - min_y) / cell_size), rows - 1);
+        return row * columns + column;
+    };
+
+    auto is_free = [&](const point_2d &pt) {
+        int cell = cell_of(pt);
+        int column = cell % columns;
+        int row = cell / columns;
+        for (int r = std::max(row - 2, 0); r <= std::min(row + 2, rows - 1); r++) {
+            for (int c = std::max(column - 2, 0); c <= std::min(column + 2, columns - 1); c++) {
+                int other = grid[r * columns + c];
+                if (other >= 0) {
+                    double dx = points[other].x - pt.x;
+                    double dy = points[other].y - pt.y;
+                    if (dx * dx + dy * dy < spacing * spacing) {
+                        return false;
+                    }
+                }
+            }
         }
-    }
-    return true;
-}
+        return true;
+    };
+
+    auto place = [&](const point_2d &pt) {
+        grid[cell_of(pt)] = points.size();
+        active.push_back(points.size());
+        points.push_back(pt);
+    };
+
+    place(point_at(min_x + rng_double(rng) * (max_x - min_x), min_y + rng_double(rng) * (max_y - min_y)));
 
-bool is_sufficient_distance(const planet_data &planet, const game_data &game) {
-    for (const auto &existing_planet : game.planets) {
-        double distance = sqrt(pow(sprite_x(planet.planet_sprite) - sprite_x(existing_planet.planet_sprite), 2)
-                            + pow(sprite_y(planet.planet_sprite) - sprite_y(existing_planet.planet_sprite), 2));
-        if (distance < 500) {
-            return false;  // The planet is too close to an existing planet
+    while (!active.empty()) {
+        int slot = rng_int(rng, active.size());
+        point_2d origin = points[active[slot]];
+        bool placed = false;
+
+        // Try candidates in the ring between spacing and twice the spacing around the point
+        for (int i = 0; i < POISSON_DISK_CANDIDATES && !placed; i++) {
+            double angle = rng_double(rng) * 2.0 * M_PI;
+            double distance = spacing * (1.0 + rng_double(rng));
+            point_2d candidate = point_at(origin.x + cos(angle) * distance, origin.y + sin(angle) * distance);
+
+            if (candidate.x >= min_x && candidate.x < max_x && candidate.y >= min_y && candidate.y < max_y && is_free(candidate)) {
+                place(candidate);
+                placed = true;
+            }
+        }
+
+        // A point with no room left around it is retired
+        if (!placed) {
+            active[slot] = active.back();
+            active.pop_back();
         }
     }
-    return true;
+
+    return points;
 }
 
-void add_planet(game_data &game) {
-    // Generate random x and y positions within the range
-    int x = rnd(MAX_X - MIN_X + 1) + MIN_X;
-    int y = rnd(MAX_Y - MIN_Y + 1) + MIN_Y;
+/**
+ * Place the game's planets once, one of each kind in a random order. The
+ * whole world is filled by Poisson-disk sampling and the planets take a
+ * random choice of the sampled points, so they are at least PLANET_SPACING
+ * apart and spread over the world rather than grown out from one spot.
+ *
+ * @param game The game data.
+ */
+void generate_planet_field(game_data &game) {
+    // Shuffle the planet kinds so each game places them differently
+    vector<planet_kind> kinds;
+    for (int kind = MERCURY; kind <= PLUTO; kind++) {
+        kinds.push_back(static_cast<planet_kind>(kind));
+    }
+    for (int i = kinds.size() - 1; i > 0; i--) {
+        std::swap(kinds[i], kinds[rng_int(game.rng, i + 1)]);
+    }
+
+    vector<point_2d> positions = poisson_disk_points(MIN_X, MIN_Y, MAX_X, MAX_Y, PLANET_SPACING, game.rng);
 
-    // Create new planet at the random position
-    planet_data planet = new_planet(x, y);
+    // Move a random choice of the points to the front, one for each kind
+    size_t count = std::min(kinds.size(), positions.size());
+    for (size_t i = 0; i < count; i++) {
+        std::swap(positions[i], positions[i + rng_int(game.rng, positions.size() - i)]);
+    }
 
-    // Check if the planet's kind is unique and it's sufficiently distant from other planets
-    if (is_unique_kind(planet, game) && is_sufficient_distance(planet, game)) {
-        // Add planet to game's planets vector
-        game.planets.push_back(planet);
+    game.planets.clear();
+    game.planets.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        game.planets.push_back(new_planet(positions[i].x, positions[i].y, kinds[i]));
     }
-}
\ No newline at end of file
+}
@@ -1,12 +1,17 @@
 #ifndef PLANET_H
 #define PLANET_H
 
-#include "splashkit.h"
+#include "platform.h"
+#include "sprites.h"
 #include "lost_in_space.h"
 #include "player.h"
 #include "power_up.h"
+#include "rng.h"
 #include <vector>
 
+// Minimum distance in pixels between two planets
+const double PLANET_SPACING = 500.0;
+
 /**
  * Enumeration of planet kinds.
  */
@@ -27,19 +32,28 @@ enum planet_kind {
  * It contains a sprite representing the planet and its kind.
  */
 struct planet_data {
-    sprite planet_sprite;   // Sprite object representing the planet
+    owned_sprite planet_sprite;   // Sprite object representing the planet
     planet_kind kind;       // Kind of the planet
 };
 
+/**
+ * Returns the bitmap associated with a planet kind.
+ *
+ * @param kind The kind of planet.
+ * @return The bitmap for the planet kind.
+ */
+bitmap planet_bitmap(planet_kind kind);
+
 /**
  * Create a new planet with the specified position.
  * It takes the x and y coordinates as input and returns a planet_data object.
  *
  * @param x The x coordinate of the planet's position.
  * @param y The y coordinate of the planet's position.
+ * @param kind The kind of planet.
  * @return A planet_data object representing the new planet.
  */
-planet_data new_planet(double x, double y);
+planet_data new_planet(double x, double y, planet_kind kind);
 
 
 /**
@@ -55,13 +69,13 @@ void draw_planet(const planet_data &planet_to_draw);
 void update_planet(const planet_data &planet_to_update);
 
 /**
- * Add a planet to the game.
- * It takes the game data as input.
- * The function generates a new planet and adds it to the game's planets vector.
+ * Place the game's planets once, when the game is created.
+ * One planet of each kind is placed, and no two planets are closer than
+ * PLANET_SPACING, so planets cost nothing per frame once the field is built.
  *
  * @param game The game data.
  */
-void add_planet(game_data &game);
+void generate_planet_field(game_data &game);
 
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+/**
+ * Platform layer for the game.
+ *
+ * Every game source includes this header instead of "splashkit.h" directly.
+ * In the normal build it simply pulls in SplashKit. When the game is compiled
+ * with LOST_IN_SPACE_HEADLESS defined, the same subset of the SplashKit API is
+ * provided by platform_headless.cpp instead, with no window, audio or input
+ * device behind it. This lets the simulation be stepped as fast as the CPU
+ * allows, e.g. by the driver in tools/headless.cpp.
+ */
+#ifdef LOST_IN_SPACE_HEADLESS
+#include "platform_headless.h"
+#else
+#include "splashkit.h"
+#endif
+
+#endif // PLATFORM_H
@@ -0,0 +1,529 @@
+#ifdef LOST_IN_SPACE_HEADLESS
+
+#include "platform_headless.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <random>
+
+// Size used for bitmaps whose image file cannot be found or read
+const int DEFAULT_BITMAP_SIZE = 64;
+
+// Window size used by the game
+const int HEADLESS_SCREEN_WIDTH = 800;
+const int HEADLESS_SCREEN_HEIGHT = 800;
+
+// Folder searched for image files to size bitmaps
+const char *HEADLESS_IMAGE_FOLDER = "Resources/images";
+
+/**
+ * In-memory bitmap: only the name and dimensions are known.
+ */
+struct headless_bitmap {
+    string name;
+    int width;
+    int height;
+};
+
+/**
+ * In-memory sprite holding the state SplashKit would keep for it.
+ */
+struct headless_sprite {
+    vector<bitmap> layers;
+    vector<bool> visible_layers;
+    double x;
+    double y;
+    double dx;
+    double dy;
+    double rotation;
+};
+
+/**
+ * In-memory timer measured against the simulated clock.
+ */
+struct headless_timer {
+    string name;
+    double start_time;
+    bool started;
+};
+
+const color COLOR_BLACK = { 0.0f, 0.0f, 0.0f, 1.0f };
+const color COLOR_WHITE = { 1.0f, 1.0f, 1.0f, 1.0f };
+const color COLOR_SNOW = { 1.0f, 0.98f, 0.98f, 1.0f };
+const color COLOR_GREEN = { 0.0f, 0.5f, 0.0f, 1.0f };
+const color COLOR_YELLOW = { 1.0f, 1.0f, 0.0f, 1.0f };
+
+// Simulated time in milliseconds, only moved by headless_advance_time
+static double simulated_ms = 0.0;
+
+// Camera position in world coordinates
+static double headless_camera_x = 0.0;
+static double headless_camera_y = 0.0;
+
+// Keyboard state driven by the headless controls
+static bool keys_down[KEY_CODE_COUNT] = { false };
+static bool keys_typed[KEY_CODE_COUNT] = { false };
+static bool keys_pending[KEY_CODE_COUNT] = { false };
+static bool quit_flag = false;
+
+// Bitmaps are created lazily on first lookup and live for the whole run
+static std::map<string, headless_bitmap *> bitmaps;
+
+// Generator behind rnd(), seeded with a constant so runs repeat
+static std::mt19937 rnd_engine(0);
+
+/**
+ * Read the width and height from the header of a PNG file.
+ *
+ * @param path The file to read.
+ * @param width Set to the image width on success.
+ * @param height Set to the image height on success.
+ * @return True if the file is a readable PNG, false otherwise.
+ */
+static bool read_png_size(const std::filesystem::path &path, int &width, int &height) {
+    FILE *file = fopen(path.string().c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    unsigned char header[24];
+    size_t read = fread(header, 1, sizeof(header), file);
+    fclose(file);
+
+    // PNG signature followed by the IHDR chunk holding big-endian width and height
+    if (read != sizeof(header) || header[1] != 'P' || header[2] != 'N' || header[3] != 'G') {
+        return false;
+    }
+
+    width = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+    height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+    return true;
+}
+
+/**
+ * Convert a string to lower case for case-insensitive name matching.
+ *
+ * @param text The string to convert.
+ * @return The lower case copy.
+ */
+static string to_lower(string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+/**
+ * Size a bitmap from the image in the resources folder with the same name.
+ *
+ * @param bmp The bitmap to size.
+ */
+static void load_bitmap_size(headless_bitmap &bmp) {
+    bmp.width = DEFAULT_BITMAP_SIZE;
+    bmp.height = DEFAULT_BITMAP_SIZE;
+
+    std::error_code error;
+    std::filesystem::directory_iterator folder(HEADLESS_IMAGE_FOLDER, error);
+    if (error) {
+        return;
+    }
+
+    string wanted = to_lower(bmp.name) + ".png";
+    for (const auto &entry : folder) {
+        if (to_lower(entry.path().filename().string()) == wanted) {
+            read_png_size(entry.path(), bmp.width, bmp.height);
+            return;
+        }
+    }
+}
+
+float rnd() {
+    return std::uniform_real_distribution<float>(0.0f, 1.0f)(rnd_engine);
+}
+
+int rnd(int ubound) {
+    if (ubound <= 0) {
+        return 0;
+    }
+    return std::uniform_int_distribution<int>(0, ubound - 1)(rnd_engine);
+}
+
+float cosine(float degrees) {
+    return static_cast<float>(cos(degrees * M_PI / 180.0));
+}
+
+float sine(float degrees) {
+    return static_cast<float>(sin(degrees * M_PI / 180.0));
+}
+
+point_2d point_at(double x, double y) {
+    return { x, y };
+}
+
+float point_point_distance(const point_2d &pt1, const point_2d &pt2) {
+    double dx = pt1.x - pt2.x;
+    double dy = pt1.y - pt2.y;
+    return static_cast<float>(sqrt(dx * dx + dy * dy));
+}
+
+string point_to_string(const point_2d &pt) {
+    return "Pt @" + std::to_string(pt.x) + ":" + std::to_string(pt.y);
+}
+
+void load_resource_bundle(const string &name, const string &filename) {
+    // Bitmaps are sized lazily by bitmap_named, nothing else needs loading
+}
+
+bitmap bitmap_named(string name) {
+    auto found = bitmaps.find(name);
+    if (found != bitmaps.end()) {
+        return found->second;
+    }
+
+    headless_bitmap *result = new headless_bitmap { name, 0, 0 };
+    load_bitmap_size(*result);
+    bitmaps[name] = result;
+    return result;
+}
+
+int bitmap_width(bitmap bmp) {
+    return bmp->width;
+}
+
+int bitmap_width(string name) {
+    return bitmap_width(bitmap_named(name));
+}
+
+int bitmap_height(bitmap bmp) {
+    return bmp->height;
+}
+
+int bitmap_height(string name) {
+    return bitmap_height(bitmap_named(name));
+}
+
+bitmap create_bitmap(string name, int width, int height) {
+    headless_bitmap *result = new headless_bitmap { name, width, height };
+    bitmaps[name] = result;
+    return result;
+}
+
+void draw_bitmap_on_bitmap(bitmap destination, bitmap to_draw, double x, double y) {
+}
+
+void clear_bitmap(bitmap bmp, color clr) {
+}
+
+sprite create_sprite(bitmap layer) {
+    headless_sprite *result = new headless_sprite();
+    result->layers.push_back(layer);
+    result->visible_layers.push_back(true);
+    return result;
+}
+
+sprite create_sprite(const string &bitmap_name) {
+    return create_sprite(bitmap_named(bitmap_name));
+}
+
+void free_sprite(sprite s) {
+    delete s;
+}
+
+int sprite_add_layer(sprite s, bitmap new_layer, const string &layer_name) {
+    s->layers.push_back(new_layer);
+    s->visible_layers.push_back(true);
+    return static_cast<int>(s->layers.size()) - 1;
+}
+
+int sprite_layer_count(sprite s) {
+    return static_cast<int>(s->layers.size());
+}
+
+bitmap sprite_layer(sprite s, int idx) {
+    return s->layers[idx];
+}
+
+int sprite_show_layer(sprite s, int id) {
+    s->visible_layers[id] = true;
+    return id;
+}
+
+void sprite_hide_layer(sprite s, int id) {
+    s->visible_layers[id] = false;
+}
+
+float sprite_x(sprite s) {
+    return static_cast<float>(s->x);
+}
+
+float sprite_y(sprite s) {
+    return static_cast<float>(s->y);
+}
+
+void sprite_set_x(sprite s, float value) {
+    s->x = value;
+}
+
+void sprite_set_y(sprite s, float value) {
+    s->y = value;
+}
+
+point_2d sprite_position(sprite s) {
+    return { s->x, s->y };
+}
+
+void sprite_set_position(sprite s, const point_2d &pos) {
+    s->x = pos.x;
+    s->y = pos.y;
+}
+
+float sprite_dx(sprite s) {
+    return static_cast<float>(s->dx);
+}
+
+float sprite_dy(sprite s) {
+    return static_cast<float>(s->dy);
+}
+
+void sprite_set_dx(sprite s, float value) {
+    s->dx = value;
+}
+
+void sprite_set_dy(sprite s, float value) {
+    s->dy = value;
+}
+
+vector_2d sprite_velocity(sprite s) {
+    return { s->dx, s->dy };
+}
+
+void sprite_set_velocity(sprite s, const vector_2d &value) {
+    s->dx = value.x;
+    s->dy = value.y;
+}
+
+float sprite_rotation(sprite s) {
+    return static_cast<float>(s->rotation);
+}
+
+void sprite_set_rotation(sprite s, float value) {
+    s->rotation = value;
+}
+
+int sprite_width(sprite s) {
+    return s->layers[0]->width;
+}
+
+int sprite_height(sprite s) {
+    return s->layers[0]->height;
+}
+
+point_2d center_point(sprite s) {
+    return { s->x + sprite_width(s) / 2.0, s->y + sprite_height(s) / 2.0 };
+}
+
+circle sprite_collision_circle(sprite s) {
+    return { center_point(s), std::max(sprite_width(s), sprite_height(s)) / 2.0 };
+}
+
+bool sprite_collision(sprite s1, sprite s2) {
+    // Bounding rectangle overlap stands in for SplashKit's pixel test
+    return s1->x < s2->x + sprite_width(s2) && s2->x < s1->x + sprite_width(s1) &&
+           s1->y < s2->y + sprite_height(s2) && s2->y < s1->y + sprite_height(s1);
+}
+
+void update_sprite(sprite s) {
+    update_sprite(s, 1.0f);
+}
+
+void update_sprite(sprite s, float pct) {
+    // As in SplashKit, the velocity is relative to the sprite's rotation
+    double radians = s->rotation * M_PI / 180.0;
+    double cos_r = cos(radians);
+    double sin_r = sin(radians);
+    s->x += (s->dx * cos_r - s->dy * sin_r) * pct;
+    s->y += (s->dx * sin_r + s->dy * cos_r) * pct;
+}
+
+void draw_sprite(sprite s) {
+}
+
+void play_sound_effect(const string &name) {
+}
+
+void play_music(const string &name) {
+}
+
+void stop_music() {
+}
+
+void process_events() {
+    for (int i = 0; i < KEY_CODE_COUNT; i++) {
+        keys_typed[i] = keys_pending[i];
+        keys_pending[i] = false;
+    }
+}
+
+bool quit_requested() {
+    return quit_flag;
+}
+
+bool key_down(key_code key) {
+    return keys_down[key];
+}
+
+bool key_typed(key_code key) {
+    return keys_typed[key];
+}
+
+timer create_timer(string name) {
+    return new headless_timer { name, 0.0, false };
+}
+
+void start_timer(timer t) {
+    t->start_time = simulated_ms;
+    t->started = true;
+}
+
+unsigned int timer_ticks(timer t) {
+    return t->started ? static_cast<unsigned int>(simulated_ms - t->start_time) : 0;
+}
+
+unsigned int current_ticks() {
+    return static_cast<unsigned int>(simulated_ms);
+}
+
+void delay(int milliseconds) {
+    headless_advance_time(milliseconds);
+}
+
+window open_window(string caption, int width, int height) {
+    return nullptr;
+}
+
+void close_window(const string &name) {
+}
+
+int screen_width() {
+    return HEADLESS_SCREEN_WIDTH;
+}
+
+int screen_height() {
+    return HEADLESS_SCREEN_HEIGHT;
+}
+
+double camera_x() {
+    return headless_camera_x;
+}
+
+double camera_y() {
+    return headless_camera_y;
+}
+
+void move_camera_by(double dx, double dy) {
+    headless_camera_x += dx;
+    headless_camera_y += dy;
+}
+
+void set_camera_position(point_2d pos) {
+    headless_camera_x = pos.x;
+    headless_camera_y = pos.y;
+}
+
+void clear_screen(color clr) {
+}
+
+void refresh_screen() {
+}
+
+void refresh_screen(unsigned int target_fps) {
+}
+
+color rgba_color(int red, int green, int blue, int alpha) {
+    return { red / 255.0f, green / 255.0f, blue / 255.0f, alpha / 255.0f };
+}
+
+color rgba_color(double red, double green, double blue, double alpha) {
+    return { static_cast<float>(red), static_cast<float>(green), static_cast<float>(blue), static_cast<float>(alpha) };
+}
+
+drawing_options option_to_screen() {
+    return { true };
+}
+
+drawing_options option_part_bmp(double x, double y, double w, double h) {
+    return { false };
+}
+
+drawing_options option_part_bmp(double x, double y, double w, double h, drawing_options opts) {
+    return opts;
+}
+
+drawing_options option_draw_to(bitmap destination) {
+    return { false };
+}
+
+drawing_options option_draw_to(bitmap destination, drawing_options opts) {
+    opts.to_screen = false;
+    return opts;
+}
+
+drawing_options option_rotate_bmp(double angle) {
+    return { false };
+}
+
+drawing_options option_rotate_bmp(double angle, drawing_options opts) {
+    return opts;
+}
+
+void draw_bitmap(bitmap bmp, double x, double y) {
+}
+
+void draw_bitmap(bitmap bmp, double x, double y, drawing_options opts) {
+}
+
+void draw_bitmap(string name, double x, double y) {
+}
+
+void draw_bitmap(string name, double x, double y, drawing_options opts) {
+}
+
+void draw_text(const string &text, const color &clr, double x, double y) {
+}
+
+void draw_text(const string &text, const color &clr, double x, double y, drawing_options opts) {
+}
+
+void fill_circle(color clr, const circle &c) {
+}
+
+void fill_circle(color clr, double x, double y, double radius, drawing_options opts) {
+}
+
+void draw_circle(color clr, double x, double y, double radius, drawing_options opts) {
+}
+
+void fill_rectangle(color clr, double x, double y, double width, double height, drawing_options opts) {
+}
+
+void headless_advance_time(double milliseconds) {
+    simulated_ms += milliseconds;
+}
+
+double headless_time_ms() {
+    return simulated_ms;
+}
+
+void headless_set_key_down(key_code key, bool down) {
+    keys_down[key] = down;
+}
+
+void headless_type_key(key_code key) {
+    keys_pending[key] = true;
+}
+
+void headless_request_quit() {
+    quit_flag = true;
+}
+
+#endif // LOST_IN_SPACE_HEADLESS
@@ -0,0 +1,227 @@
+#ifndef PLATFORM_HEADLESS_H
+#define PLATFORM_HEADLESS_H
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+/**
+ * Headless implementation of the SplashKit subset used by the game.
+ *
+ * Sprites, bitmaps and timers are plain in-memory objects, drawing and audio
+ * calls do nothing, and time only moves when headless_advance_time is called.
+ * The declarations mirror the SplashKit signatures so the game sources compile
+ * unchanged against either platform.
+ */
+
+// Forward declarations of the opaque handle types
+struct headless_sprite;
+struct headless_bitmap;
+struct headless_timer;
+
+typedef headless_sprite *sprite;
+typedef headless_bitmap *bitmap;
+typedef headless_timer *timer;
+typedef void *window;
+
+struct point_2d {
+    double x;
+    double y;
+};
+
+struct vector_2d {
+    double x;
+    double y;
+};
+
+struct circle {
+    point_2d center;
+    double radius;
+};
+
+struct rectangle {
+    double x;
+    double y;
+    double width;
+    double height;
+};
+
+struct color {
+    float r;
+    float g;
+    float b;
+    float a;
+};
+
+// Drawing options only carry what the game passes through; nothing is drawn
+struct drawing_options {
+    bool to_screen;
+};
+
+// Keys read by the game
+enum key_code {
+    UNKNOWN_KEY,
+    RETURN_KEY,
+    SPACE_KEY,
+    LEFT_KEY,
+    RIGHT_KEY,
+    UP_KEY,
+    DOWN_KEY,
+    NUM_1_KEY,
+    NUM_2_KEY,
+    NUM_3_KEY,
+    F3_KEY,
+    P_KEY,
+    KEY_CODE_COUNT
+};
+
+extern const color COLOR_BLACK;
+extern const color COLOR_WHITE;
+extern const color COLOR_SNOW;
+extern const color COLOR_GREEN;
+extern const color COLOR_YELLOW;
+
+// Random numbers
+float rnd();
+int rnd(int ubound);
+
+// Geometry and trigonometry
+float cosine(float degrees);
+float sine(float degrees);
+point_2d point_at(double x, double y);
+float point_point_distance(const point_2d &pt1, const point_2d &pt2);
+string point_to_string(const point_2d &pt);
+
+// Resources
+void load_resource_bundle(const string &name, const string &filename);
+bitmap bitmap_named(string name);
+int bitmap_width(bitmap bmp);
+int bitmap_width(string name);
+int bitmap_height(bitmap bmp);
+int bitmap_height(string name);
+bitmap create_bitmap(string name, int width, int height);
+void draw_bitmap_on_bitmap(bitmap destination, bitmap to_draw, double x, double y);
+void clear_bitmap(bitmap bmp, color clr);
+
+// Sprites
+sprite create_sprite(bitmap layer);
+sprite create_sprite(const string &bitmap_name);
+void free_sprite(sprite s);
+int sprite_add_layer(sprite s, bitmap new_layer, const string &layer_name);
+int sprite_layer_count(sprite s);
+bitmap sprite_layer(sprite s, int idx);
+int sprite_show_layer(sprite s, int id);
+void sprite_hide_layer(sprite s, int id);
+float sprite_x(sprite s);
+float sprite_y(sprite s);
+void sprite_set_x(sprite s, float value);
+void sprite_set_y(sprite s, float value);
+point_2d sprite_position(sprite s);
+void sprite_set_position(sprite s, const point_2d &pos);
+float sprite_dx(sprite s);
+float sprite_dy(sprite s);
+void sprite_set_dx(sprite s, float value);
+void sprite_set_dy(sprite s, float value);
+vector_2d sprite_velocity(sprite s);
+void sprite_set_velocity(sprite s, const vector_2d &value);
+float sprite_rotation(sprite s);
+void sprite_set_rotation(sprite s, float value);
+int sprite_width(sprite s);
+int sprite_height(sprite s);
+point_2d center_point(sprite s);
+circle sprite_collision_circle(sprite s);
+bool sprite_collision(sprite s1, sprite s2);
+void update_sprite(sprite s);
+void update_sprite(sprite s, float pct);
+void draw_sprite(sprite s);
+
+// Audio
+void play_sound_effect(const string &name);
+void play_music(const string &name);
+void stop_music();
+
+// Input
+void process_events();
+bool quit_requested();
+bool key_down(key_code key);
+bool key_typed(key_code key);
+
+// Timing
+timer create_timer(string name);
+void start_timer(timer t);
+unsigned int timer_ticks(timer t);
+unsigned int current_ticks();
+void delay(int milliseconds);
+
+// Window and camera
+window open_window(string caption, int width, int height);
+void close_window(const string &name);
+int screen_width();
+int screen_height();
+double camera_x();
+double camera_y();
+void move_camera_by(double dx, double dy);
+void set_camera_position(point_2d pos);
+void clear_screen(color clr);
+void refresh_screen();
+void refresh_screen(unsigned int target_fps);
+
+// Drawing
+color rgba_color(int red, int green, int blue, int alpha);
+color rgba_color(double red, double green, double blue, double alpha);
+drawing_options option_to_screen();
+drawing_options option_part_bmp(double x, double y, double w, double h);
+drawing_options option_part_bmp(double x, double y, double w, double h, drawing_options opts);
+drawing_options option_draw_to(bitmap destination);
+drawing_options option_draw_to(bitmap destination, drawing_options opts);
+drawing_options option_rotate_bmp(double angle);
+drawing_options option_rotate_bmp(double angle, drawing_options opts);
+void draw_bitmap(bitmap bmp, double x, double y);
+void draw_bitmap(bitmap bmp, double x, double y, drawing_options opts);
+void draw_bitmap(string name, double x, double y);
+void draw_bitmap(string name, double x, double y, drawing_options opts);
+void draw_text(const string &text, const color &clr, double x, double y);
+void draw_text(const string &text, const color &clr, double x, double y, drawing_options opts);
+void fill_circle(color clr, const circle &c);
+void fill_circle(color clr, double x, double y, double radius, drawing_options opts);
+void draw_circle(color clr, double x, double y, double radius, drawing_options opts);
+void fill_rectangle(color clr, double x, double y, double width, double height, drawing_options opts);
+
+/**
+ * Advance the simulated clock read by timer_ticks and current_ticks.
+ *
+ * @param milliseconds The amount of simulated time to add.
+ */
+void headless_advance_time(double milliseconds);
+
+/**
+ * Returns the simulated clock in milliseconds, without rounding.
+ *
+ * @return The simulated time.
+ */
+double headless_time_ms();
+
+/**
+ * Hold or release a key as seen by key_down.
+ *
+ * @param key The key to change.
+ * @param down True to hold the key, false to release it.
+ */
+void headless_set_key_down(key_code key, bool down);
+
+/**
+ * Queue a key press that key_typed reports until the next process_events.
+ *
+ * @param key The key that was typed.
+ */
+void headless_type_key(key_code key);
+
+/**
+ * Request the headless loop to quit; quit_requested returns true afterwards.
+ */
+void headless_request_quit();
+
+#endif // PLATFORM_HEADLESS_H
@@ -1,9 +1,12 @@
-#include "splashkit.h"
+#include "platform.h"
+#include "atlas.h"
 #include "lost_in_space.h"
 #include "player.h"
 #include "planets.h"
 #include "shooting.h"
 #include "enemy.h"
+#include "profiler.h"
+#include "sprites.h"
 #include <cmath>
 #include <ctime>
 #include <algorithm>
@@ -38,7 +41,7 @@ bitmap ship_bitmap(ship_kind kind) {
  * @param x The x-coordinate of the position.
  * @param y The y-coordinate of the position.
  */
-void set_sprite_position(sprite &player_sprite, double x, double y) {
+void set_sprite_position(sprite player_sprite, double x, double y) {
     sprite_set_x(player_sprite, x);
     sprite_set_y(player_sprite, y);
 }
@@ -71,7 +74,7 @@ player_data new_player() {
     bitmap default_bitmap = ship_bitmap(AQUARII);
 
     // Create the sprite with 3 layers - we can turn on and off based on the ship kind selected
-    result.player_sprite = create_sprite(default_bitmap);
+    result.player_sprite = owned_sprite(default_bitmap);
 
     // Add each ship kind as a separate layer to the player sprite
     sprite_add_layer(result.player_sprite, ship_bitmap(GLIESE), "GLIESE");
@@ -89,6 +92,7 @@ player_data new_player() {
 
     // Position the sprite in the center of the initial screen
     set_sprite_position(result.player_sprite, (800 - width) / 2, (800 - height) / 2);
+    result.previous_position = sprite_position(result.player_sprite);
 
     // initialise  attributes
     player_attributes(result);
@@ -164,11 +168,15 @@ void update_player(player_data& player_to_update, const double time_delta) {
 }
 
 /**
- * Draws the player sprite on the screen.
+ * Queues the player's shown ship layer to be drawn from the atlas.
+ * The sprite's layer index is the ship kind.
  * @param player_to_draw The player to draw.
  */
 void draw_player(const player_data &player_to_draw) {
-    draw_sprite(player_to_draw.player_sprite);
+    sprite player_sprite = player_to_draw.player_sprite;
+    bitmap ship = sprite_layer(player_sprite, static_cast<int>(player_to_draw.kind));
+    rectangle whole = { 0, 0, static_cast<double>(bitmap_width(ship)), static_cast<double>(bitmap_height(ship)) };
+    queue_image_draw(ship, whole, sprite_x(player_sprite), sprite_y(player_sprite), sprite_rotation(player_sprite), LAYER_PLAYER);
 }
 
 /**
@@ -257,13 +265,54 @@ void handle_fire(game_data &game) {
 }
 
 /**
- * Handle player input by calling individual input handling functions.
+ * Toggle the performance overlay based on keyboard input.
+ * Shows or hides the panel when F3 is typed.
+ *
+ * @param game The game data.
+ */
+void handle_overlay_toggle(game_data &game) {
+    if (key_typed(F3_KEY)) {
+        game.show_performance_overlay = !game.show_performance_overlay;
+    }
+}
+
+/**
+ * Pause or resume the game clock when P is typed.
+ *
+ * @param game The game data.
+ */
+void handle_pause_toggle(game_data &game) {
+    if (key_typed(P_KEY)) {
+        set_game_clock_paused(game.clock, !game.clock.paused);
+    }
+}
+
+/**
+ * Handle the typed keys once per frame by calling individual input handling functions.
+ * Only the pause and overlay toggles are handled while the game is paused.
  *
  * @param game The game data.
  */
 void handle_input(game_data &game) {
+    profile_scope scope(ZONE_HANDLE_INPUT);
+    handle_pause_toggle(game);
+    handle_overlay_toggle(game);
+
+    if (game.clock.paused) {
+        return;
+    }
+
     handle_ship_switch(game);
+    handle_fire(game);
+}
+
+/**
+ * Handle the held keys that steer the ship, once per simulation step, so
+ * turning and thrust do not depend on the frame rate.
+ *
+ * @param game The game data.
+ */
+void handle_steering(game_data &game) {
     handle_rotation(game);
     handle_movement(game);
-    handle_fire(game);
 }
@@ -1,7 +1,8 @@
 #ifndef LOST_IN_SPACE_PLAYER
 #define LOST_IN_SPACE_PLAYER
 
-#include "splashkit.h"
+#include "platform.h"
+#include "sprites.h"
 #include "power_up.h"
 
 // Constants can be declared as constexpr which can be evaluated at compile time.
@@ -34,6 +35,14 @@ enum ship_kind {
     PEGASI
 };
 
+/**
+ * Returns a bitmap corresponding to the given ship kind.
+ *
+ * @param kind The ship kind for which to retrieve the bitmap.
+ * @return The bitmap corresponding to the given ship kind.
+ */
+bitmap ship_bitmap(ship_kind kind);
+
 /**
  * The player data keeps track of all of the information related to the player.
  * 
@@ -56,7 +65,7 @@ enum ship_kind {
  * @field   player_ultra_boost  The player's ultra-boost speed
  */
 struct player_data {
-    sprite      player_sprite;
+    owned_sprite player_sprite;
     sprite      hud_sprite;
     ship_kind   kind;
     double      current_rotation;
@@ -71,6 +80,7 @@ struct player_data {
     double      player_speed;
     double      player_boost;
     double      player_ultra_boost;
+    point_2d    previous_position;  // Sprite position before the last simulation step, for interpolation
 };
 
 /**
@@ -93,11 +103,18 @@ void draw_player(const player_data &player_to_draw);
 void update_player(player_data &player_to_update, const double time_delta);
 
 /**
- * Read user input and update the player based on this interaction.
+ * Read the typed keys and update the player based on this interaction.
+ * Called once per frame.
  * @param game      The game_data struct holding game state information
  */
 void handle_input(game_data &game);
 
+/**
+ * Read the held keys that turn and thrust the ship. Called once per simulation step.
+ * @param game      The game_data struct holding game state information
+ */
+void handle_steering(game_data &game);
+
 /**
  * Draws the Heads Up Display (HUD) for the game. It displays information such as the player's location, coin count, rocket count, time remaining, fuel gauge, and shield gauge.
  * @param player    The player_data struct holding the player's data
@@ -144,7 +161,7 @@ void adjust_camera_position(const player_data &player);
  * @param x The x-coordinate of the position.
  * @param y The y-coordinate of the position.
  */
-void set_sprite_position(sprite &player_sprite, double x, double y);
+void set_sprite_position(sprite player_sprite, double x, double y);
 
 /**
  * Handle the player switching ships based on the user input.
@@ -167,6 +184,20 @@ void handle_rotation(game_data &game);
  */
 void handle_movement(game_data &game);
 
+/**
+ * Toggle the performance overlay in the HUD when F3 is typed.
+ * 
+ * @param game The game data holding the overlay flag.
+ */
+void handle_overlay_toggle(game_data &game);
+
+/**
+ * Pause or resume the game clock when P is typed.
+ *
+ * @param game The game data holding the clock.
+ */
+void handle_pause_toggle(game_data &game);
+
 /**
  * Handle the firing of projectiles from the player's ship based on the user input.
  * 
@@ -1,8 +1,11 @@
-#include "splashkit.h"
+#include "platform.h"
+#include "atlas.h"
 #include "lost_in_space.h"
 #include "power_up.h"
 #include "planets.h"
 #include "shooting.h"
+#include "sprites.h"
+#include "entity_container.h"
 
 // The total number of power-up types
 const int POWER_UP_TYPES = 6;
@@ -19,11 +22,12 @@ const int EXTRA_TIME = 5;
 /**
  * Generate a random power-up kind.
  * 
+ * @param rng The random number stream to draw from.
  * @return A random power-up kind selected from the available power-up types.
  */
-power_up_kind random_power_up_kind() {
+power_up_kind random_power_up_kind(rng_data &rng) {
     // Convert the random number to a power-up kind using static_cast
-    return static_cast<power_up_kind>(rnd(POWER_UP_TYPES));
+    return static_cast<power_up_kind>(rng_int(rng, POWER_UP_TYPES));
 }
 
 /**
@@ -50,34 +54,40 @@ bitmap power_up_bitmap(power_up_kind kind) {
  * 
  * @param x The x-coordinate of the power-up.
  * @param y The y-coordinate of the power-up.
+ * @param rng The random number stream used to pick the kind and velocity.
  * @return The new power-up object.
  */
-power_up_data new_power_up(double x, double y) {
+power_up_data new_power_up(double x, double y, rng_data &rng) {
     power_up_data result;
 
     // Choose a random power-up kind
-    result.kind = random_power_up_kind();
+    result.kind = random_power_up_kind(rng);
 
     // Create a new sprite for the power-up
-    result.power_up_sprite = create_sprite(power_up_bitmap(result.kind));
+    result.power_up_sprite = owned_sprite(power_up_bitmap(result.kind));
 
     // Set the initial position and velocity of the power-up
     sprite_set_position(result.power_up_sprite, {x, y});
-    sprite_set_velocity(result.power_up_sprite, {rnd() * 4 - 2, rnd() * 4 - 2});
+    result.previous_position = {x, y};
+    double dx = rng_double(rng) * 4 - 2;
+    double dy = rng_double(rng) * 4 - 2;
+    sprite_set_velocity(result.power_up_sprite, {dx, dy});
 
     result.is_visible = true; 
+    result.is_asleep = false;
+    result.expire_time = 0;
 
     return result;
 }
 
 /**
- * Draws a power-up object if it is visible.
+ * Draws a power-up object if it is visible and awake.
  * 
  * @param power_up The power-up to draw.
  */
 void draw_power_up(const power_up_data &power_up) {
-    if (power_up.is_visible) {
-        draw_sprite(power_up.power_up_sprite);
+    if (power_up.is_visible && !power_up.is_asleep) {
+        queue_sprite_draw(power_up.power_up_sprite, LAYER_POWER_UPS);
     }
 }
 
@@ -145,30 +155,36 @@ void apply_power_up(game_data &game, power_up_data &power_up) {
 }
 
 /**
- * Make a power-up bounce off the screen boundaries.
+ * Make a power-up bounce off the edges of the world. The velocity is only
+ * turned around while it still points outwards, so a power-up that is past
+ * an edge heads back in rather than flipping every frame.
  * 
  * @param power_up The power-up data to bounce.
  */
 void bounce_power_up(power_up_data &power_up) {
-    const int MIN = -1300;
-    const int MAX = 1300;
+    sprite power_up_sprite = power_up.power_up_sprite;
+    double x = sprite_x(power_up_sprite);
+    double y = sprite_y(power_up_sprite);
+    double dx = sprite_dx(power_up_sprite);
+    double dy = sprite_dy(power_up_sprite);
 
-    if (power_up.position.x > MAX || power_up.position.x < MIN) {
-        power_up.velocity.x = -power_up.velocity.x;
+    if ((x < MIN_X && dx < 0) || (x > MAX_X - sprite_width(power_up_sprite) && dx > 0)) {
+        sprite_set_dx(power_up_sprite, -dx);
     }
-    if (power_up.position.y > MAX || power_up.position.y < MIN) {
-        power_up.velocity.y = -power_up.velocity.y;
+    if ((y < MIN_Y && dy < 0) || (y > MAX_Y - sprite_height(power_up_sprite) && dy > 0)) {
+        sprite_set_dy(power_up_sprite, -dy);
     }
 }
 
 /**
- * Removes a power-up from the power-ups vector.
+ * Removes a power-up from the power-ups vector, returning its sprite.
+ * The last power-up moves into its index.
  * 
  * @param power_ups The vector of all active power-ups.
  * @param index The index of the power-up to remove.
  */
 void remove_power_up(std::vector<power_up_data> &power_ups, int index) {
-    power_ups.erase(power_ups.begin() + index);
+    swap_remove(power_ups, index);
 }
 
 /**
@@ -182,18 +198,60 @@ void update_power_up(power_up_data &power_up) {
 }
 
 /**
- * Add a new power-up to the game at a random position.
+ * Update every power-up: remove the expired ones, put the ones far off
+ * screen to sleep and move the rest. The vector is walked from the end, so
+ * the power-up moved into a removed one's index has already been updated.
+ * 
+ * @param game The game data.
+ */
+void update_power_ups(game_data &game) {
+    unsigned int now = game_clock_ticks(game.clock);
+
+    // Power-ups outside the screen grown by the margin sleep
+    double left = camera_x() - POWER_UP_SLEEP_MARGIN;
+    double top = camera_y() - POWER_UP_SLEEP_MARGIN;
+    double right = camera_x() + screen_width() + POWER_UP_SLEEP_MARGIN;
+    double bottom = camera_y() + screen_height() + POWER_UP_SLEEP_MARGIN;
+
+    for (int i = game.power_ups.size() - 1; i >= 0; i--) {
+        power_up_data &power_up = game.power_ups[i];
+
+        if (now >= power_up.expire_time) {
+            remove_power_up(game.power_ups, i);
+            continue;
+        }
+
+        double x = sprite_x(power_up.power_up_sprite);
+        double y = sprite_y(power_up.power_up_sprite);
+        power_up.is_asleep = x < left || x > right || y < top || y > bottom;
+
+        if (!power_up.is_asleep) {
+            update_power_up(power_up);
+        }
+    }
+}
+
+/**
+ * Add a new power-up to the game at a random position, unless the game
+ * already holds POWER_UP_CAPACITY power-ups.
  * 
  * @param game The game data to add the power-up to.
  */
 void add_power_up(game_data &game) {
+    if (static_cast<int>(game.power_ups.size()) >= POWER_UP_CAPACITY) {
+        return;
+    }
+
     // Generate random x and y positions within the range
-    int x = rnd(MAX_X - MIN_X + 1) + MIN_X;
-    int y = rnd(MAX_Y - MIN_Y + 1) + MIN_Y;
+    int x = rng_int(game.rng, MAX_X - MIN_X + 1) + MIN_X;
+    int y = rng_int(game.rng, MAX_Y - MIN_Y + 1) + MIN_Y;
 
     // Create new power-up at the random position
-    power_up_data power_up = new_power_up(x, y);
+    power_up_data power_up = new_power_up(x, y, game.rng);
+
+    // Despawn the power-up once its lifetime is over
+    power_up.expire_time = game_clock_ticks(game.clock) + POWER_UP_LIFETIME;
 
     // Add power-up to game's power_ups vector
-    game.power_ups.push_back(power_up);
+    game.power_ups.push_back(std::move(power_up));
 }
\ No newline at end of file
@@ -1,12 +1,23 @@
 #ifndef POWER_UP_H
 #define POWER_UP_H
 
-#include "splashkit.h"
+#include "platform.h"
+#include "sprites.h"
 #include "lost_in_space.h"
+#include "rng.h"
 
 // Add a forward declaration for game_data
 struct game_data;
 
+// Time a power-up stays in the world before it despawns, in milliseconds
+const unsigned int POWER_UP_LIFETIME = 30000;
+
+// Most power-ups in the world at once; spawns past this are skipped
+const int POWER_UP_CAPACITY = 40;
+
+// Distance beyond the edge of the screen at which power-ups go to sleep
+const double POWER_UP_SLEEP_MARGIN = 400;
+
 /**
  * Enum representing the different types of power-ups.
  */
@@ -17,23 +28,16 @@ enum power_up_kind {
     TIME    // adds extra time to the game
 };
 
-/**
- * Structure representing a point with x and y coordinates.
- */
-struct point {
-    int x; // x-coordinate of a point
-    int y; // y-coordinate of a point
-};
-
 /**
  * Structure representing power-up data.
  */
 struct power_up_data {
-    power_up_kind kind;         // The type of power-up
-    sprite power_up_sprite;     // The sprite for the power-up
-    bool is_visible;            // Visibility status of the power-up
-    point position;             // Position of the power-up
-    point velocity;             // Velocity of the power-up
+    power_up_kind kind;           // The type of power-up
+    owned_sprite power_up_sprite; // The sprite for the power-up
+    bool is_visible;              // Visibility status of the power-up
+    bool is_asleep;               // True while far off screen, when it is neither moved nor drawn
+    unsigned int expire_time;     // Game timer tick at which the power-up despawns
+    point_2d previous_position;   // Sprite position before the last simulation step, for interpolation
 };
 
 
@@ -50,19 +54,21 @@ bitmap power_up_bitmap(power_up_kind kind);
  *
  * @param x The x-coordinate of the power-up.
  * @param y The y-coordinate of the power-up.
+ * @param rng The random number stream used to pick the kind and velocity.
  * @return The newly created power-up data.
  */
-power_up_data new_power_up(double x, double y);
+power_up_data new_power_up(double x, double y, rng_data &rng);
 
 /**
- * Draws the power-up sprite on the screen.
+ * Draws the power-up sprite on the screen, unless it is asleep.
  *
  * @param power_up The power-up data to be drawn.
  */
 void draw_power_up(const power_up_data &power_up);
 
 /**
- * Removes the power-up at the given index from the power_ups vector.
+ * Removes the power-up at the given index from the power_ups vector and returns its sprite to the pool.
+ * The last power-up takes its index, so the order of the rest is not kept.
  *
  * @param power_ups The vector of power-ups.
  * @param index The index of the power-up to be removed.
@@ -85,7 +91,17 @@ void apply_power_up(game_data &game, power_up_data &power_up);
 void update_power_up(power_up_data &power_up);
 
 /**
- * Adds a new power-up to the game.
+ * Updates every power-up in the game. Expired power-ups are removed, and
+ * power-ups more than POWER_UP_SLEEP_MARGIN off screen sleep: they are
+ * not moved or drawn until the camera comes near them again.
+ *
+ * @param game The game data.
+ */
+void update_power_ups(game_data &game);
+
+/**
+ * Adds a new power-up to the game, unless it already holds POWER_UP_CAPACITY.
+ * The power-up despawns after POWER_UP_LIFETIME.
  *
  * @param game The game data.
  */
@@ -0,0 +1,261 @@
+#include "profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+// Names of the zones, in the same order as the profile_zone enumeration
+const char *ZONE_NAMES[PROFILE_ZONE_COUNT] = {
+    "frame",
+    "update",
+    "update_player",
+    "update_power_ups",
+    "update_planets",
+    "spawning",
+    "update_projectiles",
+    "player_projectile_collisions",
+    "handle_enemy_collision",
+    "update_enemies",
+    "enemy_projectile_collisions",
+    "handle_projectile_collision",
+    "update_explosions",
+    "power_up_collisions",
+    "kill_streaks",
+    "flush_destroyed",
+    "handle_input",
+    "draw",
+    "cull_view",
+    "draw_planets",
+    "draw_player",
+    "draw_enemies",
+    "draw_power_ups",
+    "draw_projectiles",
+    "draw_explosions",
+    "flush_draw_batch",
+    "draw_hud",
+    "draw_mini_map",
+    "present"
+};
+
+/**
+ * Per-frame zone timings kept in a ring buffer, plus session totals.
+ * A negative sample marks a zone that did not run in that frame.
+ */
+struct profiler_data {
+    std::vector<float> samples;                 // PROFILER_HISTORY_FRAMES rows of PROFILE_ZONE_COUNT samples
+    long frame_count = 0;                       // Frames started since the game began
+    int current_row = 0;                        // Row of the frame being recorded
+    int last_row = -1;                          // Row of the last completed frame
+    long frames_over_budget = 0;                // Frames whose ZONE_FRAME exceeded FRAME_BUDGET_MS
+    double session_max[PROFILE_ZONE_COUNT] = {};    // Largest sample seen for each zone
+    double session_total[PROFILE_ZONE_COUNT] = {};  // Sum of all samples for each zone
+    long session_runs[PROFILE_ZONE_COUNT] = {};     // Number of frames each zone ran in
+};
+
+/**
+ * A single timed span recorded while tracing.
+ */
+struct trace_event {
+    profile_zone zone;
+    long frame;             // Frame the span belongs to
+    double start_us;        // Start time relative to the start of the trace
+    double duration_us;     // Length of the span
+};
+
+/**
+ * Spans recorded for the Chrome trace export.
+ */
+struct trace_data {
+    bool active = false;
+    std::chrono::steady_clock::time_point origin;
+    std::vector<trace_event> events;
+};
+
+// The profiler is shared by the update and draw code, like SplashKit's own global state
+static profiler_data profiler;
+static trace_data trace;
+
+const char *profile_zone_name(profile_zone zone) {
+    return ZONE_NAMES[zone];
+}
+
+/**
+ * Returns the sample slot of a zone in the frame being recorded.
+ *
+ * @param zone The zone.
+ * @return The slot, or nullptr before the first frame has begun.
+ */
+static float *current_sample(profile_zone zone) {
+    if (profiler.samples.empty()) {
+        return nullptr;
+    }
+    return &profiler.samples[profiler.current_row * PROFILE_ZONE_COUNT + zone];
+}
+
+/**
+ * Starts timing a zone.
+ *
+ * @param zone The zone to add the time to.
+ */
+profile_scope::profile_scope(profile_zone zone)
+    : zone(zone), start(std::chrono::steady_clock::now()) {}
+
+/**
+ * Stops timing, accumulates the elapsed time into the zone's sample and, when
+ * tracing, records the span.
+ */
+profile_scope::~profile_scope() {
+    auto end = std::chrono::steady_clock::now();
+
+    if (trace.active) {
+        double start_us = std::chrono::duration<double, std::micro>(start - trace.origin).count();
+        double duration_us = std::chrono::duration<double, std::micro>(end - start).count();
+        trace.events.push_back({ zone, profiler.frame_count, start_us, duration_us });
+    }
+
+    float *sample = current_sample(zone);
+    if (sample == nullptr) {
+        return;
+    }
+
+    double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    *sample = std::max(*sample, 0.0f) + static_cast<float>(elapsed_ms);
+}
+
+/**
+ * Moves to the next row of the ring buffer and marks every zone as not run.
+ */
+void profiler_begin_frame() {
+    if (profiler.samples.empty()) {
+        profiler.samples.resize(static_cast<size_t>(PROFILER_HISTORY_FRAMES) * PROFILE_ZONE_COUNT);
+    }
+
+    profiler.current_row = profiler.frame_count % PROFILER_HISTORY_FRAMES;
+    std::fill_n(profiler.samples.begin() + profiler.current_row * PROFILE_ZONE_COUNT, PROFILE_ZONE_COUNT, -1.0f);
+    profiler.frame_count++;
+}
+
+/**
+ * Adds the frame's samples to the session maximum and totals.
+ */
+void profiler_end_frame() {
+    if (profiler.samples.empty()) {
+        return;
+    }
+
+    const float *row = &profiler.samples[profiler.current_row * PROFILE_ZONE_COUNT];
+    for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++) {
+        if (row[zone] >= 0.0f) {
+            profiler.session_max[zone] = std::max(profiler.session_max[zone], static_cast<double>(row[zone]));
+            profiler.session_total[zone] += row[zone];
+            profiler.session_runs[zone]++;
+        }
+    }
+
+    if (row[ZONE_FRAME] > FRAME_BUDGET_MS) {
+        profiler.frames_over_budget++;
+    }
+
+    profiler.last_row = profiler.current_row;
+}
+
+double profiler_last_frame_ms(profile_zone zone) {
+    if (profiler.last_row < 0) {
+        return 0.0;
+    }
+    return std::max(0.0f, profiler.samples[profiler.last_row * PROFILE_ZONE_COUNT + zone]);
+}
+
+void start_trace() {
+    trace.active = true;
+    trace.origin = std::chrono::steady_clock::now();
+    trace.events.clear();
+}
+
+/**
+ * Writes the recorded spans as complete ("X") trace events. Nesting is shown
+ * by the viewer from the span times, so no begin/end pairing is needed.
+ *
+ * @param path The file to write.
+ * @return True if the trace was written, false otherwise.
+ */
+bool write_trace(const std::string &path) {
+    trace.active = false;
+
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (size_t i = 0; i < trace.events.size(); i++) {
+        const trace_event &event = trace.events[i];
+        fprintf(file, "{\"name\":\"%s\",\"cat\":\"game\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1,\"args\":{\"frame\":%ld}}%s\n",
+                ZONE_NAMES[event.zone], event.start_us, event.duration_us, event.frame,
+                i + 1 < trace.events.size() ? "," : "");
+    }
+    fprintf(file, "]}\n");
+
+    fclose(file);
+    trace.events.clear();
+    return true;
+}
+
+/**
+ * Returns the value at a percentile of a sample list, reordering the list.
+ *
+ * @param values The samples.
+ * @param pct The percentile in [0, 1].
+ * @return The sample at that percentile.
+ */
+static double percentile(std::vector<float> &values, double pct) {
+    size_t index = static_cast<size_t>(pct * (values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+/**
+ * Writes one line per zone with its percentiles over the frames still in the
+ * ring buffer, and its mean and maximum over the whole session.
+ *
+ * @param path The file to write.
+ * @return True if the report was written, false otherwise.
+ */
+bool write_profile_report(const std::string &path) {
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    long history = std::min<long>(profiler.frame_count, PROFILER_HISTORY_FRAMES);
+    fprintf(file, "frames: %ld (percentiles over the last %ld)\n", profiler.frame_count, history);
+    fprintf(file, "frames over %.1f ms budget: %ld\n\n", FRAME_BUDGET_MS, profiler.frames_over_budget);
+    fprintf(file, "%-30s %8s %8s %8s %8s %8s %9s\n", "zone (ms)", "p50", "p95", "p99", "max", "mean", "frames");
+
+    std::vector<float> values;
+    values.reserve(history);
+
+    for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++) {
+        values.clear();
+        for (long row = 0; row < history; row++) {
+            float sample = profiler.samples[row * PROFILE_ZONE_COUNT + zone];
+            if (sample >= 0.0f) {
+                values.push_back(sample);
+            }
+        }
+
+        if (values.empty()) {
+            continue;
+        }
+
+        double p50 = percentile(values, 0.50);
+        double p95 = percentile(values, 0.95);
+        double p99 = percentile(values, 0.99);
+        double mean = profiler.session_total[zone] / profiler.session_runs[zone];
+
+        fprintf(file, "%-30s %8.3f %8.3f %8.3f %8.3f %8.3f %9ld\n", ZONE_NAMES[zone],
+                p50, p95, p99, profiler.session_max[zone], mean, profiler.session_runs[zone]);
+    }
+
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,108 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <string>
+
+// Number of frames kept in the profiler's ring buffer (five minutes at 60 Hz)
+const int PROFILER_HISTORY_FRAMES = 18000;
+
+// Frame budget in milliseconds for a 60 Hz display
+const double FRAME_BUDGET_MS = 1000.0 / 60.0;
+
+/**
+ * The timed zones of a frame. Each zone's time is accumulated per frame.
+ */
+enum profile_zone {
+    ZONE_FRAME,                          // The whole main loop iteration
+    ZONE_UPDATE,                         // update_game
+    ZONE_UPDATE_PLAYER,                  // update_player
+    ZONE_UPDATE_POWER_UPS,               // update_power_ups
+    ZONE_UPDATE_PLANETS,                 // update_planet for every planet
+    ZONE_SPAWNING,                       // spawn_power_ups and spawn_enemy
+    ZONE_UPDATE_PROJECTILES,             // update_projectiles
+    ZONE_PLAYER_PROJECTILE_COLLISIONS,   // check_player_projectile_collisions
+    ZONE_HANDLE_ENEMY_COLLISION,         // handle_enemy_collision, including its sound effects
+    ZONE_UPDATE_ENEMIES,                 // update_enemies
+    ZONE_ENEMY_PROJECTILE_COLLISIONS,    // check_enemy_projectile_collisions
+    ZONE_HANDLE_PROJECTILE_COLLISION,    // handle_projectile_collision
+    ZONE_UPDATE_EXPLOSIONS,              // update_explosions
+    ZONE_POWER_UP_COLLISIONS,            // check_player_power_up_collisions
+    ZONE_KILL_STREAKS,                   // update_kill_streaks
+    ZONE_FLUSH_DESTROYED,                // Removing the enemies and projectiles destroyed this frame
+    ZONE_HANDLE_INPUT,                   // handle_input
+    ZONE_DRAW,                           // draw_game
+    ZONE_CULL_VIEW,                      // cull_to_view
+    ZONE_DRAW_PLANETS,                   // draw_planet for every visible planet
+    ZONE_DRAW_PLAYER,                    // draw_player
+    ZONE_DRAW_ENEMIES,                   // draw_enemies
+    ZONE_DRAW_POWER_UPS,                 // draw_power_up for every visible power-up
+    ZONE_DRAW_PROJECTILES,               // draw_projectiles
+    ZONE_DRAW_EXPLOSIONS,                // draw_explosions
+    ZONE_FLUSH_DRAW_BATCH,               // flush_draw_batch, drawing the queued atlas quads
+    ZONE_DRAW_HUD,                       // draw_hud
+    ZONE_DRAW_MINI_MAP,                  // draw_mini_map
+    ZONE_PRESENT,                        // refresh_screen, presenting the drawn frame
+    PROFILE_ZONE_COUNT
+};
+
+/**
+ * Times the enclosing block and adds the result to a zone of the current frame.
+ */
+struct profile_scope {
+    profile_zone zone;
+    std::chrono::steady_clock::time_point start;
+
+    profile_scope(profile_zone zone);
+    ~profile_scope();
+};
+
+/**
+ * Returns the display name of a zone.
+ *
+ * @param zone The zone.
+ * @return The zone's name.
+ */
+const char *profile_zone_name(profile_zone zone);
+
+/**
+ * Starts a new frame in the ring buffer, clearing the oldest one.
+ */
+void profiler_begin_frame();
+
+/**
+ * Finishes the current frame and folds it into the session totals.
+ */
+void profiler_end_frame();
+
+/**
+ * Returns the time spent in a zone during the last completed frame.
+ *
+ * @param zone The zone.
+ * @return The time in milliseconds, or 0 if the zone did not run.
+ */
+double profiler_last_frame_ms(profile_zone zone);
+
+/**
+ * Starts recording every profiled span for export as a Chrome trace.
+ */
+void start_trace();
+
+/**
+ * Stops recording spans and writes them as Chrome trace-event JSON, which can
+ * be loaded into chrome://tracing or Perfetto.
+ *
+ * @param path The file to write.
+ * @return True if the trace was written, false otherwise.
+ */
+bool write_trace(const std::string &path);
+
+/**
+ * Writes the p50/p95/p99/max summary of every zone to a text file.
+ *
+ * @param path The file to write.
+ * @return True if the report was written, false otherwise.
+ */
+bool write_profile_report(const std::string &path);
+
+#endif // PROFILER_H
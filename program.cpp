@@ -1,4 +1,4 @@
-#include "splashkit.h"
+#include "platform.h"
 #include "enemy.h"
 #include "game_data.h"
 #include "player.h"
@@ -9,51 +9,115 @@
 #include "kill_streaks.h"
 #include "explosion.h"
 #include "collision.h"
+#include "profiler.h"
+#include "frame_limiter.h"
+#include <cstring>
+#include <ctime>
 
 /**
- * Load the game images, sounds, etc.
+ * Load the game images, sounds, etc., prewarm the sprite pools and build the texture atlas.
  */
 void load_resources() {
     load_resource_bundle("game_bundle", "lost_in_space.txt");
+    prewarm_sprite_pools();
+    build_game_atlas();
+}
+
+#ifndef LOST_IN_SPACE_HEADLESS
+// How long the game over screen is held, in milliseconds
+const double GAME_OVER_SCREEN_MS = 5000.0;
+
+/**
+ * Run one iteration of the event loop: update, input and drawing, plus the
+ * game over screen once the game ends. The whole iteration is profiled.
+ * The game over screen is held without blocking, so events keep being
+ * processed and the window can still be closed.
+ *
+ * @param game The game data.
+ * @param game_over_shown_ms Clock reading when the game over screen was shown, or a negative value before then.
+ * @param game_over Set to true once the game over screen has been held for GAME_OVER_SCREEN_MS.
+ */
+void run_frame(game_data &game, double &game_over_shown_ms, bool &game_over) {
+    profile_scope scope(ZONE_FRAME);
+
+    process_events();
+
+    if (game_over) {
+        return;
+    }
+
+    if (game_over_shown_ms >= 0.0) {
+        game_over = clock_source_ms() - game_over_shown_ms >= GAME_OVER_SCREEN_MS;
+        return;
+    }
+
+    update_game(game);
+    update_game_time(game);
+    handle_input(game);
+    draw_game(game);
+
+    if (game.state == game_state::GAME_OVER) {
+        play_music("game_over");
+        
+        // Draw "Game Over" text
+        draw_text("Game Over", COLOR_WHITE, screen_width() / 2 - 40, screen_height() / 2, option_to_screen());
+
+        refresh_screen();   // Update the screen
+        game_over_shown_ms = clock_source_ms();
+    }
 }
 
 /**
  * Entry point.
  * 
  * Manages the initialisation of data, the event loop, and quitting.
+ * Pass --trace FILE to record the session as a Chrome trace, and --uncapped
+ * to run frames as fast as possible instead of pacing them to TARGET_FPS.
  */
-int main() {
+int main(int argc, char *argv[]) {
+    const char *trace_path = nullptr;
+    bool uncapped = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--uncapped") == 0) {
+            uncapped = true;
+        }
+    }
+
+    if (trace_path != nullptr) {
+        start_trace();
+    }
+
     open_window("Lost in Space", 800, 800);
     load_resources();
 
-    game_data game = new_game();
+    // Seed from the clock so every session plays differently
+    game_data game = new_game(static_cast<uint64_t>(time(nullptr)));
+    double game_over_shown_ms = -1.0;
     bool game_over = false;
 
+    start_frame_limiter(TARGET_FPS, uncapped);
+
     do {
-        process_events();
-
-        if (!game_over) {
-            update_game(game);
-            update_game_time(game);
-            handle_input(game);
-            draw_game(game);
-
-            if (game.state == game_state::GAME_OVER) {
-                play_music("game_over");
-                
-                // Draw "Game Over" text
-                draw_text("Game Over", COLOR_WHITE, screen_width() / 2 - 40, screen_height() / 2, option_to_screen());
-
-                refresh_screen();   // Update the screen
-                delay(5000);        // wait for 5 seconds
-                game_over = true;
-            }
-        }
+        profiler_begin_frame();
+        run_frame(game, game_over_shown_ms, game_over);
+        profiler_end_frame();
 
+        // Pace outside the profiled frame, so the frame zone only measures work
+        wait_for_next_frame();
     } while (not quit_requested());
 
+    print_frame_limiter_report();
+
+    // Dump the per-zone frame time summary and the trace, if one was recorded
+    write_profile_report("profile_report.txt");
+    if (trace_path != nullptr) {
+        write_trace(trace_path);
+    }
+
     close_window("Lost in Space");
 
     return 0;
 }
-
+#endif // LOST_IN_SPACE_HEADLESS
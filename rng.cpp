@@ -0,0 +1,87 @@
+#include "rng.h"
+
+/**
+ * Rotate a 64-bit value left.
+ *
+ * @param value The value to rotate.
+ * @param bits The number of bits to rotate by.
+ * @return The rotated value.
+ */
+static inline uint64_t rotate_left(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+/**
+ * Advance a splitmix64 sequence, used to expand the seed into the full state.
+ *
+ * @param x The splitmix64 state to advance.
+ * @return The next splitmix64 output.
+ */
+static uint64_t splitmix64(uint64_t &x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Creates a new random number stream by expanding the seed with splitmix64,
+ * which never produces the all-zero state xoshiro cannot leave.
+ *
+ * @param seed The seed.
+ * @return The seeded stream.
+ */
+rng_data new_rng(uint64_t seed) {
+    rng_data result;
+    for (uint64_t &word : result.state) {
+        word = splitmix64(seed);
+    }
+    return result;
+}
+
+/**
+ * Returns the next output of the xoshiro256** generator.
+ *
+ * @param rng The stream to advance.
+ * @return The next random value.
+ */
+uint64_t rng_next(rng_data &rng) {
+    uint64_t *s = rng.state;
+    uint64_t result = rotate_left(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotate_left(s[3], 45);
+
+    return result;
+}
+
+/**
+ * Returns a random integer in [0, ubound) using a multiply-shift reduction of
+ * the top 32 bits, which avoids the cost of a modulo.
+ *
+ * @param rng The stream to advance.
+ * @param ubound The exclusive upper bound.
+ * @return The random integer.
+ */
+int rng_int(rng_data &rng, int ubound) {
+    if (ubound <= 0) {
+        return 0;
+    }
+    uint64_t high_bits = rng_next(rng) >> 32;
+    return static_cast<int>((high_bits * static_cast<uint64_t>(ubound)) >> 32);
+}
+
+/**
+ * Returns a random double in [0, 1) built from the top 53 bits.
+ *
+ * @param rng The stream to advance.
+ * @return The random value.
+ */
+double rng_double(rng_data &rng) {
+    return (rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -0,0 +1,50 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+/**
+ * State of a xoshiro256** pseudo-random number generator.
+ *
+ * The game owns a single stream in game_data and threads it through every
+ * spawn and AI decision, so the same seed and input always replay the same
+ * frames.
+ */
+struct rng_data {
+    uint64_t state[4];
+};
+
+/**
+ * Creates a new random number stream from a seed.
+ *
+ * @param seed The seed; any value, including zero, is valid.
+ * @return The seeded stream.
+ */
+rng_data new_rng(uint64_t seed);
+
+/**
+ * Returns the next 64 random bits from the stream.
+ *
+ * @param rng The stream to advance.
+ * @return The next random value.
+ */
+uint64_t rng_next(rng_data &rng);
+
+/**
+ * Returns a random integer in [0, ubound), like SplashKit's rnd(int).
+ *
+ * @param rng The stream to advance.
+ * @param ubound The exclusive upper bound.
+ * @return The random integer, or 0 if ubound is not positive.
+ */
+int rng_int(rng_data &rng, int ubound);
+
+/**
+ * Returns a random double in [0, 1), like SplashKit's rnd().
+ *
+ * @param rng The stream to advance.
+ * @return The random value.
+ */
+double rng_double(rng_data &rng);
+
+#endif // RNG_H
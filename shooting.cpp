@@ -1,6 +1,11 @@
-#include "splashkit.h"
+#include "platform.h"
 #include "shooting.h"
 #include "game_data.h"
+#include "lost_in_space.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 /**
  * Calculates the location of the point on the circumference of the sprite's circle.
@@ -24,12 +29,12 @@ point_2d circle_point_position(const sprite &ship) {
 }
 
 /**
- * Creates a new projectile based on the player's sprite and adds it to the game's projectiles vector.
+ * Creates a new projectile based on the player's sprite and adds it to the game's projectile pool.
  * 
  * @param game The game_data object containing all game-related data.
- * @param projectiles The vector of all active projectiles.
+ * @param projectiles The pool of all active projectiles.
  */
-void create_projectile(game_data& game, std::vector<projectile_data>& projectiles) {
+void create_projectile(game_data& game, projectile_pool_data& projectiles) {
     projectile_data new_projectile;
     new_projectile.shape.radius = 4;
 
@@ -44,27 +49,267 @@ void create_projectile(game_data& game, std::vector<projectile_data>& projectile
     new_projectile.speed = 1250;
     new_projectile.owner = 0;
 
-    projectiles.push_back(new_projectile);
+    add_projectile(projectiles, new_projectile);
+}
+
+/**
+ * Creates an empty projectile pool, reserving every array up front so adding
+ * projectiles never reallocates.
+ * 
+ * @param capacity The most projectiles the pool can hold.
+ * @return The new pool.
+ */
+projectile_pool_data new_projectile_pool(int capacity) {
+    projectile_pool_data projectiles;
+    projectiles.capacity = capacity;
+    projectiles.shapes.x.reserve(capacity);
+    projectiles.shapes.y.reserve(capacity);
+    projectiles.shapes.radius.reserve(capacity);
+    projectiles.vx.reserve(capacity);
+    projectiles.vy.reserve(capacity);
+    projectiles.lifetime.reserve(capacity);
+    projectiles.owner.reserve(capacity);
+    projectiles.source.reserve(capacity);
+    projectiles.damage.reserve(capacity);
+    return projectiles;
+}
+
+/**
+ * Adds a projectile to the pool. The angle is in degrees counter-clockwise,
+ * as update_projectile used it, so screen y runs opposite to the sine.
+ * 
+ * @param projectiles The pool to add to.
+ * @param projectile The projectile being fired.
+ * @return The new projectile's handle, or NULL_HANDLE if the pool was full.
+ */
+entity_handle add_projectile(projectile_pool_data& projectiles, const projectile_data& projectile) {
+    if (projectile_count(projectiles) >= projectiles.capacity) {
+        return NULL_HANDLE;
+    }
+
+    add_to_circle_batch(projectiles.shapes, projectile.shape);
+    projectiles.vx.push_back(cosine(projectile.angle) * projectile.speed);
+    projectiles.vy.push_back(-(sine(projectile.angle) * projectile.speed));
+    projectiles.lifetime.push_back(PROJECTILE_LIFETIME);
+    projectiles.owner.push_back(projectile.owner);
+    projectiles.source.push_back(projectile.source);
+    projectiles.damage.push_back(projectile.damage);
+    return handle_table_add(projectiles.handles);
+}
+
+/**
+ * Moves the last projectile's data into an index and drops the last slot of
+ * every array, leaving the handle table to the caller.
+ * 
+ * @param projectiles The pool to remove from.
+ * @param index The index of the projectile to remove.
+ */
+static void swap_remove_projectile_data(projectile_pool_data& projectiles, int index) {
+    int last = projectile_count(projectiles) - 1;
+
+    projectiles.shapes.x[index] = projectiles.shapes.x[last];
+    projectiles.shapes.y[index] = projectiles.shapes.y[last];
+    projectiles.shapes.radius[index] = projectiles.shapes.radius[last];
+    projectiles.vx[index] = projectiles.vx[last];
+    projectiles.vy[index] = projectiles.vy[last];
+    projectiles.lifetime[index] = projectiles.lifetime[last];
+    projectiles.owner[index] = projectiles.owner[last];
+    projectiles.source[index] = projectiles.source[last];
+    projectiles.damage[index] = projectiles.damage[last];
+
+    projectiles.shapes.x.pop_back();
+    projectiles.shapes.y.pop_back();
+    projectiles.shapes.radius.pop_back();
+    projectiles.vx.pop_back();
+    projectiles.vy.pop_back();
+    projectiles.lifetime.pop_back();
+    projectiles.owner.pop_back();
+    projectiles.source.pop_back();
+    projectiles.damage.pop_back();
+}
+
+/**
+ * Removes a projectile from the pool by moving the last projectile into its
+ * slot and dropping the last slot.
+ * 
+ * @param projectiles The pool to remove from.
+ * @param index The index of the projectile to remove.
+ */
+void remove_projectile(projectile_pool_data& projectiles, int index) {
+    swap_remove_projectile_data(projectiles, index);
+    handle_table_remove_index(projectiles.handles, index);
+}
+
+/**
+ * Queues a projectile to be removed at the end of the frame.
+ * 
+ * @param projectiles The pool.
+ * @param projectile The projectile to remove.
+ */
+void destroy_projectile(projectile_pool_data& projectiles, entity_handle projectile) {
+    handle_table_destroy_later(projectiles.handles, projectile);
+}
+
+/**
+ * Returns whether the projectile at an index is queued for removal.
+ * 
+ * @param projectiles The pool.
+ * @param index The index of the projectile.
+ * @return True if the projectile has been destroyed this frame, false otherwise.
+ */
+bool projectile_destroy_pending(const projectile_pool_data& projectiles, int index) {
+    return index_destroy_pending(projectiles.handles, index);
+}
+
+/**
+ * Removes every projectile queued by destroy_projectile.
+ * 
+ * @param projectiles The pool.
+ */
+void flush_destroyed_projectiles(projectile_pool_data& projectiles) {
+    flush_destroyed_entities(projectiles.handles, [&](int index) {
+        swap_remove_projectile_data(projectiles, index);
+    });
+}
+
+/**
+ * Returns the number of projectiles in the pool.
+ * 
+ * @param projectiles The pool.
+ * @return The number of projectiles.
+ */
+int projectile_count(const projectile_pool_data& projectiles) {
+    return projectiles.owner.size();
+}
+
+/**
+ * Returns the shape of a projectile in the pool.
+ * 
+ * @param projectiles The pool.
+ * @param index The index of the projectile.
+ * @return The projectile's circle.
+ */
+circle projectile_shape(const projectile_pool_data& projectiles, int index) {
+    return { { projectiles.shapes.x[index], projectiles.shapes.y[index] }, projectiles.shapes.radius[index] };
+}
+
+/**
+ * Moves and ages every projectile in the pool, 4 (AVX2) or 2 (SSE2) at a
+ * time, with a scalar loop for the remainder or for other targets, then culls
+ * the expired and out-of-world projectiles.
+ * 
+ * @param projectiles The pool to update.
+ * @param time_delta The time elapsed since the last frame.
+ */
+void update_projectiles(projectile_pool_data& projectiles, double time_delta) {
+    double *x = projectiles.shapes.x.data();
+    double *y = projectiles.shapes.y.data();
+    const double *vx = projectiles.vx.data();
+    const double *vy = projectiles.vy.data();
+    double *lifetime = projectiles.lifetime.data();
+    int count = projectile_count(projectiles);
+    int i = 0;
+
+    // Set if any projectile needs culling, so the common frame skips the cull pass
+    bool any_expired = false;
+
+#if defined(__AVX2__)
+    __m256d delta = _mm256_set1_pd(time_delta);
+    __m256d low_x = _mm256_set1_pd(MIN_X - PROJECTILE_CULL_MARGIN);
+    __m256d high_x = _mm256_set1_pd(MAX_X + PROJECTILE_CULL_MARGIN);
+    __m256d low_y = _mm256_set1_pd(MIN_Y - PROJECTILE_CULL_MARGIN);
+    __m256d high_y = _mm256_set1_pd(MAX_Y + PROJECTILE_CULL_MARGIN);
+    __m256d expired = _mm256_setzero_pd();
+
+    for (; i + 4 <= count; i += 4) {
+        __m256d new_x = _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_mul_pd(_mm256_loadu_pd(vx + i), delta));
+        __m256d new_y = _mm256_add_pd(_mm256_loadu_pd(y + i), _mm256_mul_pd(_mm256_loadu_pd(vy + i), delta));
+        __m256d new_lifetime = _mm256_sub_pd(_mm256_loadu_pd(lifetime + i), delta);
+        _mm256_storeu_pd(x + i, new_x);
+        _mm256_storeu_pd(y + i, new_y);
+        _mm256_storeu_pd(lifetime + i, new_lifetime);
+
+        expired = _mm256_or_pd(expired, _mm256_cmp_pd(new_lifetime, _mm256_setzero_pd(), _CMP_LE_OQ));
+        expired = _mm256_or_pd(expired, _mm256_or_pd(_mm256_cmp_pd(new_x, low_x, _CMP_LT_OQ), _mm256_cmp_pd(new_x, high_x, _CMP_GT_OQ)));
+        expired = _mm256_or_pd(expired, _mm256_or_pd(_mm256_cmp_pd(new_y, low_y, _CMP_LT_OQ), _mm256_cmp_pd(new_y, high_y, _CMP_GT_OQ)));
+    }
+    any_expired = _mm256_movemask_pd(expired) != 0;
+#elif defined(__SSE2__)
+    __m128d delta = _mm_set1_pd(time_delta);
+    __m128d low_x = _mm_set1_pd(MIN_X - PROJECTILE_CULL_MARGIN);
+    __m128d high_x = _mm_set1_pd(MAX_X + PROJECTILE_CULL_MARGIN);
+    __m128d low_y = _mm_set1_pd(MIN_Y - PROJECTILE_CULL_MARGIN);
+    __m128d high_y = _mm_set1_pd(MAX_Y + PROJECTILE_CULL_MARGIN);
+    __m128d expired = _mm_setzero_pd();
+
+    for (; i + 2 <= count; i += 2) {
+        __m128d new_x = _mm_add_pd(_mm_loadu_pd(x + i), _mm_mul_pd(_mm_loadu_pd(vx + i), delta));
+        __m128d new_y = _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(_mm_loadu_pd(vy + i), delta));
+        __m128d new_lifetime = _mm_sub_pd(_mm_loadu_pd(lifetime + i), delta);
+        _mm_storeu_pd(x + i, new_x);
+        _mm_storeu_pd(y + i, new_y);
+        _mm_storeu_pd(lifetime + i, new_lifetime);
+
+        expired = _mm_or_pd(expired, _mm_cmple_pd(new_lifetime, _mm_setzero_pd()));
+        expired = _mm_or_pd(expired, _mm_or_pd(_mm_cmplt_pd(new_x, low_x), _mm_cmpgt_pd(new_x, high_x)));
+        expired = _mm_or_pd(expired, _mm_or_pd(_mm_cmplt_pd(new_y, low_y), _mm_cmpgt_pd(new_y, high_y)));
+    }
+    any_expired = _mm_movemask_pd(expired) != 0;
+#endif
+
+    for (; i < count; i++) {
+        x[i] += vx[i] * time_delta;
+        y[i] += vy[i] * time_delta;
+        lifetime[i] -= time_delta;
+        any_expired = any_expired || projectile_expired(projectiles, i);
+    }
+
+    if (any_expired) {
+        cull_projectiles(projectiles);
+    }
+}
+
+/**
+ * Returns whether a projectile's lifetime has run out or it is too far outside the world.
+ * 
+ * @param projectiles The pool.
+ * @param index The index of the projectile.
+ * @return True if the projectile should be removed, false otherwise.
+ */
+bool projectile_expired(const projectile_pool_data& projectiles, int index) {
+    double x = projectiles.shapes.x[index];
+    double y = projectiles.shapes.y[index];
+    bool outside_world = x < MIN_X - PROJECTILE_CULL_MARGIN || x > MAX_X + PROJECTILE_CULL_MARGIN ||
+                         y < MIN_Y - PROJECTILE_CULL_MARGIN || y > MAX_Y + PROJECTILE_CULL_MARGIN;
+    return projectiles.lifetime[index] <= 0.0 || outside_world;
 }
 
 /**
- * Updates a projectile's position based on its speed and angle.
+ * Removes expired and out-of-world projectiles. The pool is walked from the
+ * end so each projectile moved into a released slot has already been checked.
  * 
- * @param projectile The projectile to update.
- * @param time_delta The time elapsed since the last frame, used to calculate the new position.
+ * @param projectiles The pool to cull.
  */
-void update_projectile(projectile_data &projectile, double time_delta) {
-    double dx = cosine(projectile.angle) * projectile.speed * time_delta;
-    double dy = sine(projectile.angle) * projectile.speed * time_delta;
-    projectile.shape.center.x += dx;
-    projectile.shape.center.y -= dy;
+void cull_projectiles(projectile_pool_data& projectiles) {
+    for (int i = projectile_count(projectiles) - 1; i >= 0; i--) {
+        if (projectile_expired(projectiles, i)) {
+            remove_projectile(projectiles, i);
+        }
+    }
 }
 
 /**
- * Draws a projectile on the screen.
+ * Draws the visible projectiles in the pool.
  * 
- * @param projectile The projectile to draw.
+ * @param projectiles The pool to draw.
+ * @param visible The indices of the projectiles to draw, from cull_to_view.
+ * @param lag Seconds to draw each projectile back along its velocity.
  */
-void draw_projectile(const projectile_data &projectile) {
-    fill_circle(COLOR_WHITE, projectile.shape);
-}
\ No newline at end of file
+void draw_projectiles(const projectile_pool_data& projectiles, const vector<int>& visible, double lag) {
+    for (int index : visible) {
+        circle shape = projectile_shape(projectiles, index);
+        shape.center.x -= projectiles.vx[index] * lag;
+        shape.center.y -= projectiles.vy[index] * lag;
+        fill_circle(COLOR_WHITE, shape);
+    }
+}
@@ -1,20 +1,67 @@
 #ifndef SHOOTING_H
 #define SHOOTING_H
 
-#include "splashkit.h"
+#include "platform.h"
+#include "circle_batch.h"
+#include "handle_table.h"
 #include <vector>
 
 // Forward declaration of game_data
 struct game_data;
 
+// Maximum number of live projectiles in the game's pool
+const int PROJECTILE_POOL_CAPACITY = 2048;
+
+// Seconds a projectile flies before it is removed
+const double PROJECTILE_LIFETIME = 3.0;
+
+// Distance beyond the world bounds at which a projectile is removed
+const double PROJECTILE_CULL_MARGIN = 800.0;
+
 /**
  * Structure representing the data associated with a projectile.
+ * Live projectiles are kept in a projectile_pool_data; this describes one
+ * projectile as it is fired.
  */
 struct projectile_data {
     circle shape;       // The shape of the projectile
     double angle;       // The angle of the projectile
     double speed;       // The speed of the projectile
     int owner;          // The owner of the projectile (0 for player, 1 for enemy)
+    entity_handle source = NULL_HANDLE; // The enemy that fired the projectile, if any
+    double damage = 0.0;                // Fuel damage if the source is gone when the projectile hits
+};
+
+/**
+ * Every live projectile, player and enemy alike, in structure-of-arrays form.
+ *
+ * Projectile i is the i-th element of each array. Velocities are stored as
+ * vectors, worked out once from the angle when the projectile is fired, so
+ * update_projectiles needs no trigonometry and advances the whole pool in a
+ * single SIMD loop. The shapes are a circle_batch_data, so collision checks
+ * test against the pool directly.
+ *
+ * The arrays are reserved to a fixed capacity when the pool is created and
+ * never grow past it. A projectile is released by moving the last one into
+ * its slot, so release is O(1) and the order of projectiles is not kept.
+ * Projectiles are released when they hit, when their lifetime runs out, or
+ * when they fly PROJECTILE_CULL_MARGIN past the edge of the world.
+ *
+ * Each projectile has a generational handle. Hits queue the projectile with
+ * destroy_projectile, and flush_destroyed_projectiles removes the queued
+ * projectiles at the end of the frame, so indices stay valid while the
+ * collision checks run.
+ */
+struct projectile_pool_data {
+    circle_batch_data shapes;   // Centre and radius of each projectile
+    vector<double> vx;          // Horizontal velocity in world units per second
+    vector<double> vy;          // Vertical velocity in world units per second (down is positive)
+    vector<double> lifetime;    // Seconds each projectile has left to fly
+    vector<int> owner;          // The owner of each projectile (0 for player, 1 for enemy)
+    vector<entity_handle> source;   // The enemy that fired each projectile, or NULL_HANDLE
+    vector<double> damage;      // Fuel damage of each projectile if its source is gone
+    handle_table_data handles;  // Handle of each projectile
+    int capacity;               // Most projectiles the pool holds at once
 };
 
 // Function declarations
@@ -28,27 +75,116 @@ struct projectile_data {
 point_2d circle_point_position(const sprite& ship);
 
 /**
- * Creates a new projectile and adds it to the game's projectiles vector.
+ * Creates a new projectile and adds it to the game's projectile pool.
  * 
  * @param game The game data.
- * @param projectiles The vector of projectiles in the game.
+ * @param projectiles The pool of projectiles in the game.
+ */
+void create_projectile(game_data& game, projectile_pool_data& projectiles);
+
+/**
+ * Creates an empty projectile pool with storage for a fixed number of projectiles.
+ * 
+ * @param capacity The most projectiles the pool can hold.
+ * @return The new pool.
+ */
+projectile_pool_data new_projectile_pool(int capacity);
+
+/**
+ * Adds a projectile to the pool, converting its angle and speed to a velocity.
+ * Nothing is added when the pool is full.
+ * 
+ * @param projectiles The pool to add to.
+ * @param projectile The projectile being fired.
+ * @return The new projectile's handle, or NULL_HANDLE if the pool was full.
+ */
+entity_handle add_projectile(projectile_pool_data& projectiles, const projectile_data& projectile);
+
+/**
+ * Removes a projectile from the pool in constant time. The last projectile
+ * moves into its index; every other projectile keeps its index.
+ * 
+ * @param projectiles The pool to remove from.
+ * @param index The index of the projectile to remove.
+ */
+void remove_projectile(projectile_pool_data& projectiles, int index);
+
+/**
+ * Queues a projectile to be removed at the end of the frame.
+ * 
+ * @param projectiles The pool.
+ * @param projectile The projectile to remove.
  */
-void create_projectile(game_data& game, std::vector<projectile_data>& projectiles);
+void destroy_projectile(projectile_pool_data& projectiles, entity_handle projectile);
 
 /**
- * Updates the position of the projectile based on the time delta.
+ * Returns whether the projectile at an index is queued for removal.
  * 
- * @param projectile The projectile to update.
+ * @param projectiles The pool.
+ * @param index The index of the projectile.
+ * @return True if the projectile has been destroyed this frame, false otherwise.
+ */
+bool projectile_destroy_pending(const projectile_pool_data& projectiles, int index);
+
+/**
+ * Removes every projectile queued by destroy_projectile.
+ * 
+ * @param projectiles The pool.
+ */
+void flush_destroyed_projectiles(projectile_pool_data& projectiles);
+
+/**
+ * Returns the number of projectiles in the pool.
+ * 
+ * @param projectiles The pool.
+ * @return The number of projectiles.
+ */
+int projectile_count(const projectile_pool_data& projectiles);
+
+/**
+ * Returns the shape of a projectile in the pool.
+ * 
+ * @param projectiles The pool.
+ * @param index The index of the projectile.
+ * @return The projectile's circle.
+ */
+circle projectile_shape(const projectile_pool_data& projectiles, int index);
+
+/**
+ * Moves every projectile in the pool along its velocity and ages it, then
+ * removes the projectiles that have expired or left the world.
+ * 
+ * @param projectiles The pool to update.
  * @param time_delta The time delta between updates.
  */
-void update_projectile(projectile_data& projectile, double time_delta);
+void update_projectiles(projectile_pool_data& projectiles, double time_delta);
+
+/**
+ * Returns whether a projectile's lifetime has run out or it is further than
+ * PROJECTILE_CULL_MARGIN outside the world.
+ * 
+ * @param projectiles The pool.
+ * @param index The index of the projectile.
+ * @return True if the projectile should be removed, false otherwise.
+ */
+bool projectile_expired(const projectile_pool_data& projectiles, int index);
+
+/**
+ * Removes the projectiles whose lifetime has run out or that are further than
+ * PROJECTILE_CULL_MARGIN outside the world.
+ * 
+ * @param projectiles The pool to cull.
+ */
+void cull_projectiles(projectile_pool_data& projectiles);
 
 /**
- * Draws the projectile on the screen.
+ * Draws the visible projectiles in the pool.
  * 
- * @param projectile The projectile to draw.
+ * @param projectiles The pool to draw.
+ * @param visible The indices of the projectiles to draw, from cull_to_view.
+ * @param lag Seconds to draw each projectile back along its velocity, for interpolation.
  */
-void draw_projectile(const projectile_data& projectile);
+void draw_projectiles(const projectile_pool_data& projectiles, const vector<int>& visible, double lag);
 
 
 #endif  // SHOOTING_H
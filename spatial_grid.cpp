@@ -0,0 +1,135 @@
+#include "platform.h"
+#include "spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Returns the column or row holding a world coordinate, clamped to the grid.
+ *
+ * @param value The world coordinate.
+ * @param origin The world coordinate of the grid's first column or row.
+ * @param cell_size The side length of a cell.
+ * @param count The number of columns or rows.
+ * @return The clamped column or row.
+ */
+static int grid_cell_coordinate(double value, double origin, double cell_size, int count) {
+    int cell = static_cast<int>(floor((value - origin) / cell_size));
+    return std::min(std::max(cell, 0), count - 1);
+}
+
+/**
+ * Creates an empty grid covering a rectangle of the world.
+ *
+ * @param min_x The left edge of the covered area.
+ * @param min_y The top edge of the covered area.
+ * @param max_x The right edge of the covered area.
+ * @param max_y The bottom edge of the covered area.
+ * @param cell_size The side length of a cell.
+ * @return The new grid.
+ */
+spatial_grid_data new_spatial_grid(double min_x, double min_y, double max_x, double max_y, double cell_size) {
+    spatial_grid_data grid;
+    grid.min_x = min_x;
+    grid.min_y = min_y;
+    grid.cell_size = cell_size;
+    grid.columns = std::max(1, static_cast<int>(ceil((max_x - min_x) / cell_size)));
+    grid.rows = std::max(1, static_cast<int>(ceil((max_y - min_y) / cell_size)));
+    grid.max_radius = 0.0;
+    grid.cell_start.assign(grid.columns * grid.rows + 1, 0);
+    return grid;
+}
+
+/**
+ * Sort the grid's shapes into their cells with a counting sort.
+ *
+ * @param grid The grid to rebuild.
+ */
+void rebuild_spatial_grid(spatial_grid_data &grid) {
+    int count = grid.shapes.size();
+    int cells = grid.columns * grid.rows;
+
+    grid.entry_cell.resize(count);
+    grid.entries.resize(count);
+    std::fill(grid.cell_start.begin(), grid.cell_start.end(), 0);
+    grid.max_radius = 0.0;
+    grid.removed.assign(count, false);
+
+    // Count the shapes in each cell, shifted by one so the prefix sum gives start offsets
+    for (int i = 0; i < count; i++) {
+        const circle &shape = grid.shapes[i];
+        int column = grid_cell_coordinate(shape.center.x, grid.min_x, grid.cell_size, grid.columns);
+        int row = grid_cell_coordinate(shape.center.y, grid.min_y, grid.cell_size, grid.rows);
+        grid.entry_cell[i] = row * grid.columns + column;
+        grid.cell_start[grid.entry_cell[i] + 1]++;
+        grid.max_radius = std::max(grid.max_radius, shape.radius);
+    }
+
+    for (int c = 0; c < cells; c++) {
+        grid.cell_start[c + 1] += grid.cell_start[c];
+    }
+
+    // Place each index at the next free slot of its cell; cell_start is shifted
+    // down by one cell as the slots are used, then restored below
+    for (int i = 0; i < count; i++) {
+        grid.entries[grid.cell_start[grid.entry_cell[i]]++] = i;
+    }
+
+    for (int c = cells; c > 0; c--) {
+        grid.cell_start[c] = grid.cell_start[c - 1];
+    }
+    grid.cell_start[0] = 0;
+
+    clear_circle_batch(grid.packed);
+    for (int e = 0; e < count; e++) {
+        add_to_circle_batch(grid.packed, grid.shapes[grid.entries[e]]);
+    }
+}
+
+/**
+ * Stop reporting an entity until the next rebuild.
+ *
+ * @param grid The grid to update.
+ * @param index The entity's index.
+ */
+void spatial_grid_remove(spatial_grid_data &grid, int index) {
+    grid.removed[index] = true;
+}
+
+/**
+ * Find the highest-indexed shape in the grid that collides with a circle.
+ * Searches every cell within the circle's radius plus the largest shape radius.
+ *
+ * @param grid The grid to search.
+ * @param shape The circle to test.
+ * @return The index of the colliding entity, or -1 if there is none.
+ */
+int spatial_grid_last_hit(const spatial_grid_data &grid, const circle &shape) {
+    double reach = shape.radius + grid.max_radius;
+    int first_column = grid_cell_coordinate(shape.center.x - reach, grid.min_x, grid.cell_size, grid.columns);
+    int last_column = grid_cell_coordinate(shape.center.x + reach, grid.min_x, grid.cell_size, grid.columns);
+    int first_row = grid_cell_coordinate(shape.center.y - reach, grid.min_y, grid.cell_size, grid.rows);
+    int last_row = grid_cell_coordinate(shape.center.y + reach, grid.min_y, grid.cell_size, grid.rows);
+
+    int result = -1;
+    for (int row = first_row; row <= last_row; row++) {
+        for (int column = first_column; column <= last_column; column++) {
+            int cell = row * grid.columns + column;
+            for (int first = grid.cell_start[cell]; first < grid.cell_start[cell + 1]; first += CIRCLE_BATCH_BLOCK) {
+                int count = std::min(CIRCLE_BATCH_BLOCK, grid.cell_start[cell + 1] - first);
+                uint64_t hits = circle_batch_collisions(shape, grid.packed, first, count);
+
+                while (hits != 0) {
+                    int bit = highest_hit(hits);
+                    hits &= ~(uint64_t(1) << bit);
+
+                    int index = grid.entries[first + bit];
+                    if (index > result && !grid.removed[index]) {
+                        result = index;
+                    }
+                }
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,75 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "platform.h"
+#include "circle_batch.h"
+
+// Side length of a grid cell in world units
+const double SPATIAL_GRID_CELL_SIZE = 128.0;
+
+/**
+ * Uniform grid over the game world used as a collision broad phase.
+ *
+ * The caller fills shapes with one circle per entity, indexed the same way as
+ * the entity vector, and calls rebuild_spatial_grid. The rebuild is a counting
+ * sort of the indices by cell into vectors that are reused from tick to tick,
+ * so it allocates nothing once the grid has grown to the entity count.
+ * Positions outside the world are clamped into the edge cells.
+ *
+ * Entities killed between rebuilds are passed to spatial_grid_remove so they
+ * are no longer reported. Their vector must keep its indices until the next
+ * rebuild, e.g. by marking entities and compacting after the queries.
+ */
+struct spatial_grid_data {
+    double min_x;               // World x of the left edge of the first column
+    double min_y;               // World y of the top edge of the first row
+    double cell_size;           // Side length of a cell
+    int columns;                // Number of cells across
+    int rows;                   // Number of cells down
+    double max_radius;          // Largest shape radius since the last rebuild
+    vector<circle> shapes;      // Shape of each entity, by entity index
+    vector<int> entry_cell;     // Cell of each entity, by entity index
+    vector<int> cell_start;     // Cell c holds entries[cell_start[c]] up to entries[cell_start[c + 1]]
+    vector<int> entries;        // Entity indices grouped by cell
+    circle_batch_data packed;   // Shapes in the same order as entries, for the batched collision test
+    vector<bool> removed;       // Whether each entity has been removed since the last rebuild
+};
+
+/**
+ * Creates an empty grid covering a rectangle of the world.
+ *
+ * @param min_x The left edge of the covered area.
+ * @param min_y The top edge of the covered area.
+ * @param max_x The right edge of the covered area.
+ * @param max_y The bottom edge of the covered area.
+ * @param cell_size The side length of a cell.
+ * @return The new grid.
+ */
+spatial_grid_data new_spatial_grid(double min_x, double min_y, double max_x, double max_y, double cell_size);
+
+/**
+ * Sort the grid's shapes into their cells. Call after changing shapes.
+ *
+ * @param grid The grid to rebuild.
+ */
+void rebuild_spatial_grid(spatial_grid_data &grid);
+
+/**
+ * Stop reporting an entity until the next rebuild.
+ *
+ * @param grid The grid to update.
+ * @param index The entity's index.
+ */
+void spatial_grid_remove(spatial_grid_data &grid, int index);
+
+/**
+ * Find the highest-indexed shape in the grid that collides with a circle.
+ * Only the cells the circle could reach are searched.
+ *
+ * @param grid The grid to search.
+ * @param shape The circle to test.
+ * @return The index of the colliding entity, or -1 if there is none.
+ */
+int spatial_grid_last_hit(const spatial_grid_data &grid, const circle &shape);
+
+#endif // SPATIAL_GRID_H
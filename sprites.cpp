@@ -0,0 +1,154 @@
+#include "platform.h"
+#include "sprites.h"
+#include <unordered_map>
+#include <vector>
+
+// Free sprites of each bitmap, ready to be handed out again
+static std::unordered_map<bitmap, std::vector<sprite>> sprite_pools;
+
+// The pool each sprite created here belongs to
+static std::unordered_map<sprite, std::vector<sprite> *> sprite_owners;
+
+// Number of sprites taken through create_tracked_sprite and not yet returned
+static int live_sprites = 0;
+
+// Number of free sprites across all pools
+static int pooled_sprites = 0;
+
+/**
+ * Creates a new sprite for a pool and records which pool it belongs to.
+ *
+ * @param layer The bitmap for the sprite's first layer.
+ * @param pool The bitmap's pool.
+ * @return The new sprite.
+ */
+static sprite create_pool_sprite(bitmap layer, std::vector<sprite> &pool) {
+    sprite result = create_sprite(layer);
+    sprite_owners[result] = &pool;
+    return result;
+}
+
+/**
+ * Takes a sprite for a bitmap from its pool, creating one if the pool is
+ * empty, and counts it as live.
+ *
+ * @param layer The bitmap for the sprite's first layer.
+ * @return The sprite, at the origin with no velocity or rotation.
+ */
+sprite create_tracked_sprite(bitmap layer) {
+    std::vector<sprite> &pool = sprite_pools[layer];
+    live_sprites++;
+
+    if (pool.empty()) {
+        return create_pool_sprite(layer, pool);
+    }
+
+    sprite result = pool.back();
+    pool.pop_back();
+    pooled_sprites--;
+
+    // Clear the state left by the sprite's last user
+    sprite_set_position(result, point_at(0, 0));
+    sprite_set_velocity(result, { 0, 0 });
+    sprite_set_rotation(result, 0);
+    return result;
+}
+
+/**
+ * Takes a sprite for a named bitmap from its pool and counts it as live.
+ *
+ * @param bitmap_name The name of the bitmap for the sprite's first layer.
+ * @return The sprite, at the origin with no velocity or rotation.
+ */
+sprite create_tracked_sprite(const std::string &bitmap_name) {
+    return create_tracked_sprite(bitmap_named(bitmap_name));
+}
+
+/**
+ * Returns a sprite to its bitmap's pool and removes it from the live count.
+ * A sprite with extra layers is freed instead, since the next user of the
+ * pool would not expect them.
+ *
+ * @param s The sprite to return.
+ */
+void free_tracked_sprite(sprite s) {
+    live_sprites--;
+
+    auto owner = sprite_owners.find(s);
+    if (sprite_layer_count(s) > 1) {
+        sprite_owners.erase(owner);
+        free_sprite(s);
+        return;
+    }
+
+    pooled_sprites++;
+    owner->second->push_back(s);
+}
+
+owned_sprite::owned_sprite() : value(nullptr) {
+}
+
+owned_sprite::owned_sprite(bitmap layer) : value(create_tracked_sprite(layer)) {
+}
+
+owned_sprite::owned_sprite(const std::string &bitmap_name) : value(create_tracked_sprite(bitmap_name)) {
+}
+
+owned_sprite::owned_sprite(owned_sprite &&other) noexcept : value(other.value) {
+    other.value = nullptr;
+}
+
+owned_sprite &owned_sprite::operator=(owned_sprite &&other) noexcept {
+    if (this != &other) {
+        reset();
+        value = other.value;
+        other.value = nullptr;
+    }
+    return *this;
+}
+
+owned_sprite::~owned_sprite() {
+    reset();
+}
+
+/**
+ * Returns the owned sprite to its pool, leaving the owner empty.
+ */
+void owned_sprite::reset() {
+    if (value != nullptr) {
+        free_tracked_sprite(value);
+        value = nullptr;
+    }
+}
+
+/**
+ * Creates sprites for a bitmap until its pool holds at least count free sprites.
+ *
+ * @param layer The bitmap to create sprites for.
+ * @param count The number of free sprites wanted in the pool.
+ */
+void prewarm_sprite_pool(bitmap layer, int count) {
+    std::vector<sprite> &pool = sprite_pools[layer];
+    while (static_cast<int>(pool.size()) < count) {
+        pool.push_back(create_pool_sprite(layer, pool));
+        pooled_sprites++;
+    }
+}
+
+/**
+ * Returns the number of sprites taken and not yet returned.
+ *
+ * @return The live sprite count.
+ */
+int live_sprite_count() {
+    return live_sprites;
+}
+
+/**
+ * Returns the number of free sprites waiting in the pools.
+ *
+ * @return The pooled sprite count.
+ */
+int pooled_sprite_count() {
+    return pooled_sprites;
+}
@@ -0,0 +1,90 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include "platform.h"
+#include <string>
+
+/**
+ * Game sprites are pooled per bitmap. create_tracked_sprite takes a sprite
+ * from the bitmap's pool when one is free, and free_tracked_sprite puts it
+ * back instead of freeing it, so spawning and despawning entities does not
+ * create and free SplashKit sprites. Sprites given extra layers, like the
+ * player's, are freed instead of pooled when they are returned.
+ *
+ * Entities hold their sprite in an owned_sprite, which returns it when the
+ * entity is destroyed, so removing an entity from its vector or dropping a
+ * rejected one cannot leak its sprite.
+ */
+
+/**
+ * Takes a sprite for a bitmap from its pool, creating one if the pool is
+ * empty, and counts it as live. All game sprites are created here so that
+ * sprites which are never freed show up in live_sprite_count.
+ *
+ * @param layer The bitmap for the sprite's first layer.
+ * @return The sprite, at the origin with no velocity or rotation.
+ */
+sprite create_tracked_sprite(bitmap layer);
+
+/**
+ * Takes a sprite for a named bitmap from its pool and counts it as live.
+ *
+ * @param bitmap_name The name of the bitmap for the sprite's first layer.
+ * @return The sprite, at the origin with no velocity or rotation.
+ */
+sprite create_tracked_sprite(const std::string &bitmap_name);
+
+/**
+ * Returns a sprite taken with create_tracked_sprite to its bitmap's pool.
+ *
+ * @param s The sprite to return.
+ */
+void free_tracked_sprite(sprite s);
+
+/**
+ * Move-only owner of a sprite taken with create_tracked_sprite. The sprite is
+ * returned with free_tracked_sprite when the owner is destroyed or assigned
+ * over. It converts to sprite, so it can be passed straight to SplashKit.
+ */
+struct owned_sprite {
+    sprite value;   // The owned sprite, or nullptr when empty
+
+    owned_sprite();
+    explicit owned_sprite(bitmap layer);
+    explicit owned_sprite(const std::string &bitmap_name);
+    owned_sprite(owned_sprite &&other) noexcept;
+    owned_sprite &operator=(owned_sprite &&other) noexcept;
+    owned_sprite(const owned_sprite &) = delete;
+    owned_sprite &operator=(const owned_sprite &) = delete;
+    ~owned_sprite();
+
+    operator sprite() const { return value; }
+
+    // Returns the sprite to its pool now, leaving the owner empty
+    void reset();
+};
+
+/**
+ * Creates sprites for a bitmap ahead of time, until its pool holds at least
+ * the given number of free sprites.
+ *
+ * @param layer The bitmap to create sprites for.
+ * @param count The number of free sprites wanted in the pool.
+ */
+void prewarm_sprite_pool(bitmap layer, int count);
+
+/**
+ * Returns the number of sprites taken and not yet returned.
+ *
+ * @return The live sprite count.
+ */
+int live_sprite_count();
+
+/**
+ * Returns the number of free sprites waiting in the pools.
+ *
+ * @return The pooled sprite count.
+ */
+int pooled_sprite_count();
+
+#endif // SPRITES_H
@@ -0,0 +1,210 @@
+#include "../platform.h"
+#include "../game_data.h"
+#include "../lost_in_space.h"
+#include "../player.h"
+#include "../profiler.h"
+#include "../sprites.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef LOST_IN_SPACE_HEADLESS
+#error "tools/headless.cpp must be compiled with -DLOST_IN_SPACE_HEADLESS"
+#endif
+
+// Simulated length of one frame in milliseconds (60 Hz)
+const double FRAME_MS = 1000.0 / 60.0;
+
+/**
+ * Options read from the command line.
+ */
+struct headless_options {
+    long frames;    // Number of frames to simulate
+    bool draw;      // Whether to run the (no-op) draw pass as well
+    uint64_t seed;  // Seed for the first game; later games are seeded from it
+    const char *profile_path;   // Where to write the profiler report, or nullptr
+    const char *trace_path;     // Where to write the Chrome trace, or nullptr
+};
+
+/**
+ * Read the command line options, falling back to the defaults.
+ *
+ * @param argc The argument count.
+ * @param argv The argument values.
+ * @return The parsed options.
+ */
+headless_options parse_options(int argc, char *argv[]) {
+    headless_options options = { 36000, false, 1, nullptr, nullptr };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            options.frames = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--draw") == 0) {
+            options.draw = true;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            options.profile_path = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            options.trace_path = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--frames N] [--draw] [--seed S] [--profile FILE] [--trace FILE]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    return options;
+}
+
+/**
+ * Drive the player with a fixed input pattern so that movement, turning and
+ * shooting are all exercised.
+ *
+ * @param frame The frame number being simulated.
+ */
+void script_input(long frame) {
+    headless_set_key_down(UP_KEY, frame % 240 < 180);
+    headless_set_key_down(LEFT_KEY, frame % 300 < 40);
+    headless_set_key_down(RIGHT_KEY, frame % 420 >= 380);
+
+    if (frame % 20 == 0) {
+        headless_type_key(SPACE_KEY);
+    }
+}
+
+/**
+ * Mix a value into a running FNV-1a hash.
+ *
+ * @param hash The hash to update.
+ * @param value The value whose bytes are mixed in.
+ */
+void hash_value(uint64_t &hash, double value) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&value);
+    for (size_t i = 0; i < sizeof(value); i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+    }
+}
+
+/**
+ * Mix the positions and key state of every entity into the running hash, so
+ * two runs with the same seed can be checked for bit-identical frames.
+ *
+ * @param hash The hash to update.
+ * @param game The game whose state is hashed.
+ */
+void hash_frame(uint64_t &hash, const game_data &game) {
+    hash_value(hash, sprite_x(game.player.player_sprite));
+    hash_value(hash, sprite_y(game.player.player_sprite));
+    hash_value(hash, game.player.kill_count);
+
+    for (const enemy_data &enemy : game.enemies) {
+        hash_value(hash, sprite_x(enemy.enemy_sprite));
+        hash_value(hash, sprite_y(enemy.enemy_sprite));
+        hash_value(hash, sprite_rotation(enemy.enemy_sprite));
+        hash_value(hash, enemy.health);
+    }
+    for (int i = 0; i < projectile_count(game.projectiles); i++) {
+        hash_value(hash, game.projectiles.shapes.x[i]);
+        hash_value(hash, game.projectiles.shapes.y[i]);
+    }
+    for (const power_up_data &power_up : game.power_ups) {
+        hash_value(hash, sprite_x(power_up.power_up_sprite));
+        hash_value(hash, sprite_y(power_up.power_up_sprite));
+    }
+    for (const planet_data &planet : game.planets) {
+        hash_value(hash, sprite_x(planet.planet_sprite));
+        hash_value(hash, sprite_y(planet.planet_sprite));
+    }
+}
+
+/**
+ * Entry point for the headless simulation.
+ *
+ * Steps the game for a fixed number of frames with no window, audio or input
+ * device, starting a new game whenever one ends, and prints a summary.
+ * Exits with an error if any sprite is still live after the last game is
+ * destroyed.
+ */
+int main(int argc, char *argv[]) {
+    headless_options options = parse_options(argc, argv);
+    prewarm_sprite_pools();
+    build_game_atlas();
+
+    game_data game = new_game(options.seed);
+    game.state = game_state::IN_PROGRESS;
+    game.show_performance_overlay = options.draw;
+    int games_played = 1;
+    uint64_t state_hash = 0xCBF29CE484222325ULL;
+
+    if (options.trace_path != nullptr) {
+        start_trace();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (long frame = 0; frame < options.frames; frame++) {
+        script_input(frame);
+        process_events();
+
+        profiler_begin_frame();
+        {
+            profile_scope scope(ZONE_FRAME);
+
+            update_game(game);
+            update_game_time(game);
+            handle_input(game);
+
+            if (options.draw) {
+                draw_game(game);
+            }
+        }
+        profiler_end_frame();
+
+        hash_frame(state_hash, game);
+
+        if (game.state == game_state::GAME_OVER) {
+            game = new_game(rng_next(game.rng));
+            game.state = game_state::IN_PROGRESS;
+            game.show_performance_overlay = options.draw;
+            games_played++;
+        }
+
+        headless_advance_time(FRAME_MS);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("frames:        %ld\n", options.frames);
+    printf("games played:  %d\n", games_played);
+    printf("wall time:     %.3f s\n", seconds);
+    printf("frames/sec:    %.0f\n", options.frames / seconds);
+    printf("enemies:       %zu\n", game.enemies.size());
+    printf("projectiles:   %d\n", projectile_count(game.projectiles));
+    printf("power-ups:     %zu\n", game.power_ups.size());
+    printf("explosions:    %d\n", explosion_count(game.explosions));
+    printf("planets:       %zu\n", game.planets.size());
+    printf("live sprites:  %d\n", live_sprite_count());
+    printf("pooled sprites: %d\n", pooled_sprite_count());
+    printf("state hash:    %016llx\n", static_cast<unsigned long long>(state_hash));
+
+    // Every sprite is owned by an entity of the game, so none may be left once it is gone
+    game = game_data();
+    if (live_sprite_count() != 0) {
+        fprintf(stderr, "sprite leak: %d sprites still live after the game was destroyed\n", live_sprite_count());
+        return 1;
+    }
+
+    if (options.profile_path != nullptr && !write_profile_report(options.profile_path)) {
+        fprintf(stderr, "could not write %s\n", options.profile_path);
+        return 1;
+    }
+
+    if (options.trace_path != nullptr && !write_trace(options.trace_path)) {
+        fprintf(stderr, "could not write %s\n", options.trace_path);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,355 @@
+#include "../platform.h"
+#include "../game_data.h"
+#include "../lost_in_space.h"
+#include "../circle_batch.h"
+#include "../collision.h"
+#include "../enemy.h"
+#include "../hud.h"
+#include "../shooting.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef LOST_IN_SPACE_HEADLESS
+#error "tools/micro_bench.cpp must be compiled with -DLOST_IN_SPACE_HEADLESS"
+#endif
+
+// Seed for the fixed input distributions
+const uint64_t INPUT_SEED = 12345;
+
+// Number of inputs each kernel is run over per pass
+const int INPUT_COUNT = 4096;
+
+// Number of timed passes; the median pass is reported
+const int PASSES = 31;
+
+// Number of enemies checked against by is_safe_distance_from_enemies
+const int SPAWN_CHECK_ENEMIES = 32;
+
+// Results are folded into this so the compiler cannot drop the kernels
+volatile double benchmark_sink = 0.0;
+
+/**
+ * Result of one kernel.
+ */
+struct kernel_result {
+    std::string name;
+    double ns_per_op;
+};
+
+/**
+ * Options read from the command line.
+ */
+struct micro_options {
+    const char *out_path;       // Where to write the JSON, or nullptr for stdout
+    const char *compare_path;   // Baseline to compare against, or nullptr
+    double threshold;           // Allowed slowdown before a kernel is flagged, e.g. 0.15 for 15%
+};
+
+/**
+ * Read the command line options, falling back to the defaults.
+ *
+ * @param argc The argument count.
+ * @param argv The argument values.
+ * @return The parsed options.
+ */
+micro_options parse_options(int argc, char *argv[]) {
+    micro_options options = { nullptr, nullptr, 0.15 };
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--out") == 0 && has_value) {
+            options.out_path = argv[++i];
+        } else if (strcmp(argv[i], "--compare") == 0 && has_value) {
+            options.compare_path = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && has_value) {
+            options.threshold = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--out FILE] [--compare BASELINE] [--threshold FRACTION]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    return options;
+}
+
+/**
+ * Time a kernel over PASSES passes and return the median time per operation.
+ *
+ * @param name The kernel's name.
+ * @param ops_per_pass The number of operations one pass performs.
+ * @param pass Runs one pass of the kernel.
+ * @return The kernel's result.
+ */
+kernel_result time_kernel(const std::string &name, int ops_per_pass, const std::function<void()> &pass) {
+    // Warm caches and branch predictors before timing
+    pass();
+
+    std::vector<double> pass_ns;
+    for (int i = 0; i < PASSES; i++) {
+        auto start = std::chrono::steady_clock::now();
+        pass();
+        pass_ns.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::nth_element(pass_ns.begin(), pass_ns.begin() + PASSES / 2, pass_ns.end());
+    return { name, pass_ns[PASSES / 2] / ops_per_pass };
+}
+
+/**
+ * Returns a random point anywhere in the game world.
+ *
+ * @param rng The random number stream.
+ * @return The point.
+ */
+point_2d random_world_point(rng_data &rng) {
+    return point_at(rng_int(rng, MAX_X - MIN_X + 1) + MIN_X, rng_int(rng, MAX_Y - MIN_Y + 1) + MIN_Y);
+}
+
+/**
+ * Create enemies at random world positions and rotations.
+ *
+ * @param game The game providing the player and random number stream.
+ * @param count The number of enemies.
+ * @return The enemies.
+ */
+std::vector<enemy_data> make_enemies(game_data &game, int count) {
+    const std::vector<enemy_data> no_enemies;
+    std::vector<enemy_data> result;
+
+    for (int i = 0; i < count; i++) {
+        enemy_kind kind = static_cast<enemy_kind>(rng_int(game.rng, 4));
+        result.push_back(new_enemy(kind, game.player, no_enemies, game.rng));
+        sprite_set_position(result.back().enemy_sprite, random_world_point(game.rng));
+        sprite_set_rotation(result.back().enemy_sprite, rng_int(game.rng, 360));
+    }
+
+    return result;
+}
+
+/**
+ * Run every kernel over its fixed input distribution.
+ *
+ * @return The results, one per kernel.
+ */
+std::vector<kernel_result> run_kernels() {
+    game_data game = new_game(INPUT_SEED);
+    game.state = game_state::IN_PROGRESS;
+    rng_data &rng = game.rng;
+
+    std::vector<kernel_result> results;
+
+    // circle_collision: random pairs of projectile-sized and ship-sized circles
+    std::vector<circle> first(INPUT_COUNT), second(INPUT_COUNT);
+    for (int i = 0; i < INPUT_COUNT; i++) {
+        first[i] = { random_world_point(rng), 4.0 + rng_int(rng, 3) };
+        second[i] = { random_world_point(rng), 20.0 + rng_int(rng, 60) };
+    }
+    results.push_back(time_kernel("circle_collision", INPUT_COUNT, [&]() {
+        int hits = 0;
+        for (int i = 0; i < INPUT_COUNT; i++) {
+            hits += circle_collision(first[i], second[i]);
+        }
+        benchmark_sink = benchmark_sink + hits;
+    }));
+
+    // circle_batch_collisions: each first circle against the second circles, a block at a time
+    circle_batch_data packed;
+    for (const circle &shape : second) {
+        add_to_circle_batch(packed, shape);
+    }
+    const int BATCH_QUERIES = 64;
+    results.push_back(time_kernel("circle_batch_collisions", BATCH_QUERIES * INPUT_COUNT, [&]() {
+        uint64_t hits = 0;
+        for (int q = 0; q < BATCH_QUERIES; q++) {
+            for (int i = 0; i < INPUT_COUNT; i += CIRCLE_BATCH_BLOCK) {
+                hits ^= circle_batch_collisions(first[q], packed, i, CIRCLE_BATCH_BLOCK);
+            }
+        }
+        benchmark_sink = benchmark_sink + hits;
+    }));
+
+    // update_projectiles: a pool of projectiles at random positions, angles and game speeds.
+    // The 32 timed and warm-up frames move a shot at most ~670 units and well
+    // under its lifetime, so none is culled and every pass updates the full pool
+    projectile_pool_data projectiles = new_projectile_pool(INPUT_COUNT);
+    for (int i = 0; i < INPUT_COUNT; i++) {
+        projectile_data projectile = { { random_world_point(rng), 4.0 }, 0.0, 0.0, 0 };
+        projectile.angle = rng_int(rng, 360);
+        projectile.speed = rng_int(rng, 2) ? 1000 : 1250;
+        projectile.owner = rng_int(rng, 2);
+        add_projectile(projectiles, projectile);
+    }
+    results.push_back(time_kernel("update_projectiles", INPUT_COUNT, [&]() {
+        update_projectiles(projectiles, 1.0 / 60.0);
+        benchmark_sink = benchmark_sink + projectiles.shapes.x[0];
+    }));
+
+    // update_enemy_orientation and update_enemy_position: enemies spread over the world
+    std::vector<enemy_data> enemies = make_enemies(game, INPUT_COUNT);
+    results.push_back(time_kernel("update_enemy_orientation", INPUT_COUNT, [&]() {
+        for (enemy_data &enemy : enemies) {
+            update_enemy_orientation(enemy, game.player);
+        }
+        benchmark_sink = benchmark_sink + enemies[0].rotation_diff;
+    }));
+
+    // CHASE and PATROL only, so the kernel never fires projectiles
+    for (size_t i = 0; i < enemies.size(); i++) {
+        enemies[i].state = i % 2 == 0 ? CHASE : PATROL;
+    }
+    results.push_back(time_kernel("update_enemy_position", INPUT_COUNT, [&]() {
+        for (enemy_data &enemy : enemies) {
+            update_enemy_position(enemy, game.player, game);
+        }
+        benchmark_sink = benchmark_sink + enemies[0].new_x;
+    }));
+
+    // Mini-map math: the batched enemy transform, distance and fade of draw_mini_map
+    std::vector<point_2d> enemy_points;
+    results.push_back(time_kernel("mini_map_math", INPUT_COUNT, [&]() {
+        point_2d player_point = mini_map_coordinate(game.player.player_sprite, game, MINI_MAP_WIDTH, MINI_MAP_HEIGHT);
+        enemy_points.clear();
+        for (const enemy_data &enemy : enemies) {
+            enemy_points.push_back(point_at(sprite_x(enemy.enemy_sprite), sprite_y(enemy.enemy_sprite)));
+        }
+        mini_map_transform(enemy_points, game, MINI_MAP_WIDTH, MINI_MAP_HEIGHT);
+        double total = 0.0;
+        for (const point_2d &enemy_point : enemy_points) {
+            total += calculate_alpha(distance_between_points(player_point, enemy_point));
+        }
+        benchmark_sink = benchmark_sink + total;
+    }));
+
+    // is_safe_distance_from_enemies: random spawn candidates against a small crowd, packed once as new_enemy does
+    std::vector<enemy_data> crowd = make_enemies(game, SPAWN_CHECK_ENEMIES);
+    circle_batch_data crowd_centers;
+    pack_enemy_centers(crowd, crowd_centers);
+    std::vector<point_2d> candidates(INPUT_COUNT);
+    for (point_2d &candidate : candidates) {
+        candidate = random_world_point(rng);
+    }
+    results.push_back(time_kernel("is_safe_distance_from_enemies", INPUT_COUNT, [&]() {
+        int safe = 0;
+        for (const point_2d &candidate : candidates) {
+            safe += is_safe_distance_from_enemies(candidate, crowd_centers);
+        }
+        benchmark_sink = benchmark_sink + safe;
+    }));
+
+    return results;
+}
+
+/**
+ * Write the results as JSON with one kernel per line.
+ *
+ * @param file The file to write to.
+ * @param results The kernel results.
+ */
+void write_json(FILE *file, const std::vector<kernel_result> &results) {
+    fprintf(file, "{\n  \"kernels\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        fprintf(file, "    {\"name\": \"%s\", \"ns_per_op\": %.3f}%s\n",
+                results[i].name.c_str(), results[i].ns_per_op, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+/**
+ * Read a results file written by write_json.
+ *
+ * @param path The file to read.
+ * @param baseline Filled with the ns/op of each kernel by name.
+ * @return True if the file could be read, false otherwise.
+ */
+bool read_baseline(const char *path, std::map<std::string, double> &baseline) {
+    FILE *file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        char name[128];
+        double ns_per_op;
+        if (sscanf(line, " {\"name\": \"%127[^\"]\", \"ns_per_op\": %lf", name, &ns_per_op) == 2) {
+            baseline[name] = ns_per_op;
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+/**
+ * Compare the results with a baseline and report every kernel's change.
+ *
+ * @param results The new results.
+ * @param baseline The baseline ns/op by kernel name.
+ * @param threshold The allowed slowdown as a fraction.
+ * @return The number of kernels slower than the baseline by more than the threshold.
+ */
+int compare_with_baseline(const std::vector<kernel_result> &results, const std::map<std::string, double> &baseline, double threshold) {
+    int regressions = 0;
+
+    for (const kernel_result &result : results) {
+        auto found = baseline.find(result.name);
+        if (found == baseline.end()) {
+            fprintf(stderr, "%-32s %9.3f ns/op  (no baseline)\n", result.name.c_str(), result.ns_per_op);
+            continue;
+        }
+
+        double change = result.ns_per_op / found->second - 1.0;
+        bool regressed = change > threshold;
+        regressions += regressed;
+
+        fprintf(stderr, "%-32s %9.3f ns/op  baseline %9.3f  %+6.1f%%%s\n", result.name.c_str(),
+                result.ns_per_op, found->second, change * 100.0, regressed ? "  REGRESSION" : "");
+    }
+
+    return regressions;
+}
+
+/**
+ * Entry point for the hot kernel microbenchmarks.
+ *
+ * Times each kernel over a fixed input distribution and writes ns/op as JSON.
+ * With --compare, exits with status 1 if any kernel is slower than the
+ * baseline by more than the threshold.
+ */
+int main(int argc, char *argv[]) {
+    micro_options options = parse_options(argc, argv);
+    std::vector<kernel_result> results = run_kernels();
+
+    FILE *file = options.out_path != nullptr ? fopen(options.out_path, "w") : stdout;
+    if (file == nullptr) {
+        fprintf(stderr, "could not write %s\n", options.out_path);
+        return 1;
+    }
+    write_json(file, results);
+    if (file != stdout) {
+        fclose(file);
+    }
+
+    if (options.compare_path != nullptr) {
+        std::map<std::string, double> baseline;
+        if (!read_baseline(options.compare_path, baseline)) {
+            fprintf(stderr, "could not read %s\n", options.compare_path);
+            return 1;
+        }
+
+        int regressions = compare_with_baseline(results, baseline, options.threshold);
+        if (regressions > 0) {
+            fprintf(stderr, "%d kernel(s) regressed by more than %.0f%%\n", regressions, options.threshold * 100.0);
+            return 1;
+        }
+    }
+
+    return 0;
+}
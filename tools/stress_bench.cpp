@@ -0,0 +1,296 @@
+#include "../platform.h"
+#include "../game_data.h"
+#include "../lost_in_space.h"
+#include "../enemy.h"
+#include "../explosion.h"
+#include "../interpolation.h"
+#include "../power_up.h"
+#include "../shooting.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef LOST_IN_SPACE_HEADLESS
+#error "tools/stress_bench.cpp must be compiled with -DLOST_IN_SPACE_HEADLESS"
+#endif
+
+// Simulated length of one frame in milliseconds (60 Hz)
+const double FRAME_MS = 1000.0 / 60.0;
+
+/**
+ * Number of each kind of entity placed in the world for one scenario.
+ */
+struct scenario_counts {
+    int enemies;
+    int projectiles;
+    int power_ups;
+    int explosions;
+};
+
+/**
+ * Timing results of one scenario.
+ */
+struct scenario_result {
+    scenario_counts counts;
+    double update_ns_per_frame;
+    double draw_ns_per_frame;
+};
+
+/**
+ * Options read from the command line.
+ */
+struct bench_options {
+    std::vector<scenario_counts> scenarios;
+    int frames;             // Frames simulated per scenario
+    bool draw;              // Whether to time draw_in_progress as well
+    uint64_t seed;          // Seed used for every scenario
+    const char *out_path;   // Where to write the JSON, or nullptr for stdout
+};
+
+/**
+ * Parse a comma separated list of entity counts, e.g. "10,100,1000".
+ *
+ * @param text The list to parse.
+ * @return One scenario per count, with every entity kind at that count.
+ */
+std::vector<scenario_counts> parse_scale(const char *text) {
+    std::vector<scenario_counts> result;
+    std::string list = text;
+    size_t start = 0;
+
+    while (start < list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        int count = atoi(list.substr(start, end - start).c_str());
+        result.push_back({ count, count, count, count });
+        start = end + 1;
+    }
+
+    return result;
+}
+
+/**
+ * Read the command line options, falling back to the defaults.
+ *
+ * @param argc The argument count.
+ * @param argv The argument values.
+ * @return The parsed options.
+ */
+bench_options parse_options(int argc, char *argv[]) {
+    bench_options options = { parse_scale("10,100,1000,10000"), 120, false, 1, nullptr };
+    scenario_counts single = { -1, -1, -1, -1 };
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--scale") == 0 && has_value) {
+            options.scenarios = parse_scale(argv[++i]);
+        } else if (strcmp(argv[i], "--enemies") == 0 && has_value) {
+            single.enemies = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--projectiles") == 0 && has_value) {
+            single.projectiles = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--power-ups") == 0 && has_value) {
+            single.power_ups = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--explosions") == 0 && has_value) {
+            single.explosions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && has_value) {
+            options.frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && has_value) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--out") == 0 && has_value) {
+            options.out_path = argv[++i];
+        } else if (strcmp(argv[i], "--draw") == 0) {
+            options.draw = true;
+        } else {
+            fprintf(stderr, "usage: %s [--scale N,N,...] [--enemies N] [--projectiles N] [--power-ups N] "
+                            "[--explosions N] [--frames N] [--draw] [--seed S] [--out FILE]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    // Explicit per-kind counts replace the scale list with a single scenario
+    if (single.enemies >= 0 || single.projectiles >= 0 || single.power_ups >= 0 || single.explosions >= 0) {
+        single.enemies = std::max(single.enemies, 0);
+        single.projectiles = std::max(single.projectiles, 0);
+        single.power_ups = std::max(single.power_ups, 0);
+        single.explosions = std::max(single.explosions, 0);
+        options.scenarios = { single };
+    }
+
+    return options;
+}
+
+/**
+ * Returns a random point anywhere in the game world.
+ *
+ * @param game The game whose random number stream is used.
+ * @return The point.
+ */
+point_2d random_world_point(game_data &game) {
+    double x = rng_int(game.rng, MAX_X - MIN_X + 1) + MIN_X;
+    double y = rng_int(game.rng, MAX_Y - MIN_Y + 1) + MIN_Y;
+    return point_at(x, y);
+}
+
+/**
+ * Build a game populated with the scenario's entities, spread over the world.
+ *
+ * Enemies are created with new_enemy against an empty list, because its
+ * spacing check can only fit a handful of enemies on the first screen, and
+ * are then moved to random world positions, along with the position they
+ * are interpolated from. Projectiles are player shots,
+ * as create_projectile fires, scattered and aimed randomly.
+ *
+ * @param counts The scenario to build.
+ * @param seed The seed for the game.
+ * @return The populated game.
+ */
+game_data build_scenario(const scenario_counts &counts, uint64_t seed) {
+    game_data game = new_game(seed);
+    game.state = game_state::IN_PROGRESS;
+    clear_enemies(game);
+    game.projectiles = new_projectile_pool(std::max(counts.projectiles, PROJECTILE_POOL_CAPACITY));
+
+    const std::vector<enemy_data> no_enemies;
+    for (int i = 0; i < counts.enemies; i++) {
+        enemy_kind kind = static_cast<enemy_kind>(rng_int(game.rng, 4));
+        enemy_data enemy = new_enemy(kind, game.player, no_enemies, game.rng);
+        point_2d position = random_world_point(game);
+        sprite_set_position(enemy.enemy_sprite, position);
+        enemy.previous_position = position;  // Interpolate from here, not from the spawn point
+        insert_enemy(game, std::move(enemy));
+    }
+
+    for (int i = 0; i < counts.projectiles; i++) {
+        projectile_data projectile = { { random_world_point(game), 4 }, 0.0, 1250, 0 };
+        projectile.angle = rng_int(game.rng, 360);
+        add_projectile(game.projectiles, projectile);
+    }
+
+    for (int i = 0; i < counts.power_ups; i++) {
+        add_power_up(game);
+    }
+
+    for (int i = 0; i < counts.explosions; i++) {
+        point_2d position = random_world_point(game);
+        add_explosion(game, position.x, position.y);
+    }
+
+    return game;
+}
+
+/**
+ * Run one scenario for a fixed number of frames and time it.
+ *
+ * @param counts The scenario to run.
+ * @param options The benchmark options.
+ * @return The measured times.
+ */
+scenario_result run_scenario(const scenario_counts &counts, const bench_options &options) {
+    game_data game = build_scenario(counts, options.seed);
+
+    double update_ns = 0.0;
+    double draw_ns = 0.0;
+
+    for (int frame = 0; frame < options.frames; frame++) {
+        auto start = std::chrono::steady_clock::now();
+        tick_game_clock(game.clock);
+        while (game_clock_step(game.clock)) {
+            save_previous_positions(game);
+            update_in_progress(game, GAME_CLOCK_STEP);
+        }
+        auto updated = std::chrono::steady_clock::now();
+
+        update_ns += std::chrono::duration<double, std::nano>(updated - start).count();
+
+        if (options.draw) {
+            draw_in_progress(game);
+            draw_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - updated).count();
+        }
+
+        headless_advance_time(FRAME_MS);
+    }
+
+    return { counts, update_ns / options.frames, draw_ns / options.frames };
+}
+
+/**
+ * Write the results as JSON. Each scenario after the first also reports the
+ * empirical scaling exponent of the update time against the previous one,
+ * where 1 means linear and 2 means quadratic growth.
+ *
+ * @param file The file to write to.
+ * @param options The benchmark options.
+ * @param results The scenario results, in run order.
+ */
+void write_json(FILE *file, const bench_options &options, const std::vector<scenario_result> &results) {
+    fprintf(file, "{\n  \"frames\": %d,\n  \"draw\": %s,\n  \"seed\": %llu,\n  \"scenarios\": [\n",
+            options.frames, options.draw ? "true" : "false", static_cast<unsigned long long>(options.seed));
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const scenario_result &result = results[i];
+        const scenario_counts &counts = result.counts;
+        int entities = counts.enemies + counts.projectiles + counts.power_ups + counts.explosions;
+
+        fprintf(file, "    {\"enemies\": %d, \"projectiles\": %d, \"power_ups\": %d, \"explosions\": %d, "
+                      "\"update_ns_per_frame\": %.0f, \"draw_ns_per_frame\": %.0f, \"ns_per_frame\": %.0f",
+                counts.enemies, counts.projectiles, counts.power_ups, counts.explosions,
+                result.update_ns_per_frame, result.draw_ns_per_frame,
+                result.update_ns_per_frame + result.draw_ns_per_frame);
+
+        if (i > 0) {
+            const scenario_result &previous = results[i - 1];
+            int previous_entities = previous.counts.enemies + previous.counts.projectiles +
+                                    previous.counts.power_ups + previous.counts.explosions;
+            if (entities > 0 && previous_entities > 0 && entities != previous_entities) {
+                double exponent = log(result.update_ns_per_frame / previous.update_ns_per_frame) /
+                                  log(static_cast<double>(entities) / previous_entities);
+                fprintf(file, ", \"update_scaling_exponent\": %.2f", exponent);
+            }
+        }
+
+        fprintf(file, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+}
+
+/**
+ * Entry point for the stress benchmark.
+ *
+ * Runs update_in_progress (and optionally draw_in_progress) over worlds with
+ * growing numbers of entities and reports ns/frame and scaling as JSON.
+ */
+int main(int argc, char *argv[]) {
+    bench_options options = parse_options(argc, argv);
+    prewarm_sprite_pools();
+    build_game_atlas();
+
+    std::vector<scenario_result> results;
+    for (const scenario_counts &counts : options.scenarios) {
+        results.push_back(run_scenario(counts, options));
+        fprintf(stderr, "%d enemies, %d projectiles, %d power-ups, %d explosions: %.0f ns/frame\n",
+                counts.enemies, counts.projectiles, counts.power_ups, counts.explosions,
+                results.back().update_ns_per_frame + results.back().draw_ns_per_frame);
+    }
+
+    FILE *file = options.out_path != nullptr ? fopen(options.out_path, "w") : stdout;
+    if (file == nullptr) {
+        fprintf(stderr, "could not write %s\n", options.out_path);
+        return 1;
+    }
+
+    write_json(file, options, results);
+
+    if (file != stdout) {
+        fclose(file);
+    }
+
+    return 0;
+}
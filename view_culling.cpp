@@ -0,0 +1,97 @@
+#include "platform.h"
+#include "view_culling.h"
+#include "game_data.h"
+
+/**
+ * Returns the part of the world shown on screen, grown by a margin.
+ *
+ * @param margin The distance to grow the view by.
+ * @return The view bounds.
+ */
+view_bounds current_view_bounds(double margin) {
+    return {
+        camera_x() - margin,
+        camera_y() - margin,
+        camera_x() + screen_width() + margin,
+        camera_y() + screen_height() + margin
+    };
+}
+
+/**
+ * Returns whether a rectangle overlaps the view.
+ *
+ * @param view The view bounds.
+ * @param x The left of the rectangle.
+ * @param y The top of the rectangle.
+ * @param width The width of the rectangle.
+ * @param height The height of the rectangle.
+ * @return True if any part of the rectangle is in view, false otherwise.
+ */
+bool rectangle_in_view(const view_bounds &view, double x, double y, double width, double height) {
+    return x + width >= view.left && x <= view.right && y + height >= view.top && y <= view.bottom;
+}
+
+/**
+ * Returns whether a sprite overlaps the view.
+ *
+ * @param view The view bounds.
+ * @param s The sprite.
+ * @return True if any part of the sprite is in view, false otherwise.
+ */
+bool sprite_in_view(const view_bounds &view, sprite s) {
+    return rectangle_in_view(view, sprite_x(s), sprite_y(s), sprite_width(s), sprite_height(s));
+}
+
+/**
+ * Fill the visible lists with the entities that overlap the current view.
+ *
+ * @param game The game to cull.
+ * @param visible The lists to fill.
+ */
+void cull_to_view(const game_data &game, visible_lists_data &visible) {
+    view_bounds view = current_view_bounds(VIEW_CULL_MARGIN);
+
+    visible.planets.clear();
+    for (size_t i = 0; i < game.planets.size(); i++) {
+        if (sprite_in_view(view, game.planets[i].planet_sprite)) {
+            visible.planets.push_back(i);
+        }
+    }
+
+    visible.enemies.clear();
+    for (size_t i = 0; i < game.enemies.size(); i++) {
+        if (sprite_in_view(view, game.enemies[i].enemy_sprite)) {
+            visible.enemies.push_back(i);
+        }
+    }
+
+    // Sleeping power-ups are further off screen than the margin, so they are skipped without a test
+    visible.power_ups.clear();
+    for (size_t i = 0; i < game.power_ups.size(); i++) {
+        const power_up_data &power_up = game.power_ups[i];
+        if (!power_up.is_asleep && sprite_in_view(view, power_up.power_up_sprite)) {
+            visible.power_ups.push_back(i);
+        }
+    }
+
+    // Projectiles are tested on the packed circle arrays, without building each circle
+    const circle_batch_data &shapes = game.projectiles.shapes;
+    visible.projectiles.clear();
+    for (int i = 0; i < projectile_count(game.projectiles); i++) {
+        double radius = shapes.radius[i];
+        if (rectangle_in_view(view, shapes.x[i] - radius, shapes.y[i] - radius, radius * 2, radius * 2)) {
+            visible.projectiles.push_back(i);
+        }
+    }
+
+    // Every explosion is drawn at the size of one cell of the sheet
+    const explosion_ring_data &explosions = game.explosions;
+    int capacity = explosions.slots.size();
+    visible.explosions.clear();
+    for (int i = 0; i < explosions.count; i++) {
+        const explosion_data &explosion = explosions.slots[(explosions.head + i) % capacity];
+        if (rectangle_in_view(view, explosion.position.x, explosion.position.y, explosions.cells[0].width, explosions.cells[0].height)) {
+            visible.explosions.push_back(i);
+        }
+    }
+}
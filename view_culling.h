@@ -0,0 +1,75 @@
+#ifndef VIEW_CULLING_H
+#define VIEW_CULLING_H
+
+#include "platform.h"
+#include <vector>
+
+struct game_data;
+
+// Distance outside the screen that still counts as visible, in pixels
+const double VIEW_CULL_MARGIN = 64;
+
+/**
+ * The part of the world shown on screen, grown by a margin, in world
+ * coordinates.
+ */
+struct view_bounds {
+    double left;    // Left edge
+    double top;     // Top edge
+    double right;   // Right edge
+    double bottom;  // Bottom edge
+};
+
+/**
+ * Indices of the entities that overlap the view in the current frame, built
+ * by cull_to_view before drawing so that only these reach SplashKit. The
+ * lists are cleared and refilled each frame, keeping their memory.
+ */
+struct visible_lists_data {
+    vector<int> planets;        // Indices into game.planets
+    vector<int> enemies;        // Indices into game.enemies
+    vector<int> power_ups;      // Indices into game.power_ups
+    vector<int> projectiles;    // Indices into the projectile pool
+    vector<int> explosions;     // Offsets from the head of the explosion ring
+};
+
+/**
+ * Returns the part of the world shown on screen, from the camera position
+ * and screen size, grown by a margin on every side.
+ *
+ * @param margin The distance to grow the view by.
+ * @return The view bounds.
+ */
+view_bounds current_view_bounds(double margin);
+
+/**
+ * Returns whether a rectangle overlaps the view.
+ *
+ * @param view The view bounds.
+ * @param x The left of the rectangle.
+ * @param y The top of the rectangle.
+ * @param width The width of the rectangle.
+ * @param height The height of the rectangle.
+ * @return True if any part of the rectangle is in view, false otherwise.
+ */
+bool rectangle_in_view(const view_bounds &view, double x, double y, double width, double height);
+
+/**
+ * Returns whether a sprite overlaps the view.
+ *
+ * @param view The view bounds.
+ * @param s The sprite.
+ * @return True if any part of the sprite is in view, false otherwise.
+ */
+bool sprite_in_view(const view_bounds &view, sprite s);
+
+/**
+ * Fill the visible lists with the planets, enemies, power-ups, projectiles
+ * and explosions that overlap the current view, grown by VIEW_CULL_MARGIN.
+ *
+ * @param game The game to cull.
+ * @param visible The lists to fill.
+ */
+void cull_to_view(const game_data &game, visible_lists_data &visible);
+
+#endif // VIEW_CULLING_H